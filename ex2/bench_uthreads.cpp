@@ -0,0 +1,509 @@
+#include "uthreads.h"
+#include "uthread_pool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sched.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+/*
+ * uthreads microbenchmarks.
+ * Usage: bench_uthreads [quantum_usecs [cpu]]
+ * Every benchmark runs inside a single uthread_init() session, and the results are printed to stdout as one JSON
+ * object so they can be compared between builds. When cpu is given the library is pinned to it before any thread
+ * is spawned; running the suite once pinned to the CPU that owns the memory and once unpinned (or pinned to a CPU on
+ * another socket) shows the cost of remote memory and core migration. Otherwise the affinity benchmark compares
+ * the same workload unpinned and pinned within the run.
+ *
+ * Remember that every spawned thread gets only STACK_SIZE bytes of stack: the thread entry points below only touch
+ * globals and never print.
+ */
+
+//--------------Consts:
+static const int DEFAULT_QUANTUM_USECS = 1000;
+static const int SPAWN_ITERATIONS = 10000;
+static const int BLOCK_RESUME_ITERATIONS = 10000;
+static const int AFFINITY_ITERATIONS = 10000;
+static const int BATCH_ROUNDS = 20;
+static const int POOL_WORKERS = 4;
+static const int POOL_CAPACITY = 64;
+static const int POOL_JOBS = 200;
+static const long long SWITCHED_OUT_NS = 5000;  // A longer gap in a spin loop means the spinner was switched out.
+static const int SWITCH_SAMPLES = 500;
+static const int SLEEP_SAMPLES = 200;
+static const unsigned int SLEEP_USECS = 2000;
+static const int FAIRNESS_ROUNDS = 5;               // Quantums each thread should get in a fairness run.
+static const int FAIRNESS_LEVELS[] = {10, 100, 1000, 10000};
+static const long long NSEC_PER_SEC = 1000000000LL;
+static const long long NSEC_PER_USEC = 1000LL;
+
+//-------------Static Globals (shared with the benchmarked threads):
+static volatile int switchSamplesTaken = 0;
+static volatile int lastSeenQuantum = 0;
+static volatile long long lastTickNs = 0;
+static long long switchSamples[SWITCH_SAMPLES];
+
+static uthread_pool* benchPool = nullptr;
+static volatile int poolJobsDone = 0;
+static volatile int poolDriverDone = 0;
+
+static volatile int sleepSamplesTaken = 0;
+static long long sleepSamples[SLEEP_SAMPLES];
+
+static std::vector<std::string> results;
+
+//-------------Helpers:
+
+/**
+ * @return The current monotonic time in nanoseconds.
+ */
+static long long nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * Returns the requested percentile of the (sorted) samples.
+ * @param sorted: samples sorted in ascending order.
+ * @param count: the number of samples.
+ * @param p: the percentile, in [0, 100].
+ */
+static long long percentile(const long long* sorted, int count, int p)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    int index = (int)(((long long)(count - 1) * p) / 100);
+    return sorted[index];
+}
+
+/**
+ * Adds a benchmark result, given as the inner part of a JSON object, to the report.
+ */
+static void addResult(const std::string& name, const std::string& fields)
+{
+    results.push_back("{\"name\": \"" + name + "\", " + fields + "}");
+}
+
+static std::string field(const char* key, double value)
+{
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "\"%s\": %.3f", key, value);
+    return std::string(buffer);
+}
+
+static std::string field(const char* key, long long value)
+{
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "\"%s\": %lld", key, value);
+    return std::string(buffer);
+}
+
+static void failBench(const char* what)
+{
+    fprintf(stderr, "bench_uthreads: %s failed.\n", what);
+    exit(1);
+}
+
+//-------------Thread Entry Points:
+
+static void idleThread()
+{
+    while (true) {}
+}
+
+/**
+ * Spins and measures the gap between the last instruction observed before a timer preemption and the first one
+ * observed after it. The loop is shared by all the participating threads, so the gap is the cost of the
+ * SIGVTALRM handler plus the context switch itself.
+ */
+static void switchSpin()
+{
+    while (switchSamplesTaken < SWITCH_SAMPLES)
+    {
+        int quantum = uthread_get_total_quantums();
+        long long now = nowNs();
+        if (quantum != lastSeenQuantum)
+        {
+            if (lastSeenQuantum != 0)
+            {
+                switchSamples[switchSamplesTaken] = now - lastTickNs;
+                switchSamplesTaken = switchSamplesTaken + 1;
+            }
+            lastSeenQuantum = quantum;
+        }
+        lastTickNs = now;
+    }
+}
+
+static void switchThread()
+{
+    switchSpin();
+    idleThread();
+}
+
+static void countJob()
+{
+    poolJobsDone = poolJobsDone + 1;
+}
+
+/**
+ * Submits the pool's jobs one at a time and waits for each of them, so every job pays a full round trip through a
+ * parked worker.
+ */
+static void poolDriverThread()
+{
+    for (int i = 0; i < POOL_JOBS; ++i)
+    {
+        benchPool->submit(countJob)->wait();
+    }
+    poolDriverDone = 1;
+    idleThread();
+}
+
+/**
+ * Sleeps repeatedly and records how late every wakeup was.
+ */
+static void sleepThread()
+{
+    while (sleepSamplesTaken < SLEEP_SAMPLES)
+    {
+        long long before = nowNs();
+        uthread_sleep(SLEEP_USECS);
+        sleepSamples[sleepSamplesTaken] = nowNs() - before - SLEEP_USECS * NSEC_PER_USEC;
+        sleepSamplesTaken = sleepSamplesTaken + 1;
+    }
+    uthread_terminate(uthread_get_tid());
+}
+
+//-------------Benchmarks:
+
+static void benchSpawnTerminate()
+{
+    long long start = nowNs();
+    for (int i = 0; i < SPAWN_ITERATIONS; ++i)
+    {
+        int tid = uthread_spawn(idleThread);
+        if (tid < 0 || uthread_terminate(tid) < 0)
+        {
+            failBench("spawn_terminate");
+        }
+    }
+    long long elapsed = nowNs() - start;
+    addResult("spawn_terminate",
+              field("iterations", (long long)SPAWN_ITERATIONS) + ", " +
+              field("ns_per_op", (double)elapsed / SPAWN_ITERATIONS) + ", " +
+              field("ops_per_sec", SPAWN_ITERATIONS * (double)NSEC_PER_SEC / elapsed));
+}
+
+static void benchBlockResume()
+{
+    int tid = uthread_spawn(idleThread);
+    if (tid < 0)
+    {
+        failBench("block_resume");
+    }
+    long long start = nowNs();
+    for (int i = 0; i < BLOCK_RESUME_ITERATIONS; ++i)
+    {
+        if (uthread_block(tid) < 0 || uthread_resume(tid) < 0)
+        {
+            failBench("block_resume");
+        }
+    }
+    long long elapsed = nowNs() - start;
+    uthread_terminate(tid);
+    addResult("block_resume",
+              field("iterations", (long long)BLOCK_RESUME_ITERATIONS) + ", " +
+              field("ns_per_round_trip", (double)elapsed / BLOCK_RESUME_ITERATIONS));
+}
+
+/**
+ * Compares the per thread cost of spawning / resuming a full batch of threads one by one against doing it with a
+ * single uthread_spawn_n / uthread_resume_many call. A round in which the main thread was preempted also pays for
+ * every spawned thread's quantum, so the best round of each kind is reported.
+ */
+static void benchBatch()
+{
+    const int batch = MAX_THREAD_NUM - 1;
+    std::vector<int> tids(batch);
+    long long spawnOne = NSEC_PER_SEC, spawnMany = NSEC_PER_SEC;
+    long long resumeOne = NSEC_PER_SEC, resumeMany = NSEC_PER_SEC;
+
+    for (int round = 0; round < BATCH_ROUNDS; ++round)
+    {
+        long long start = nowNs();
+        for (int i = 0; i < batch; ++i)
+        {
+            tids[i] = uthread_spawn(idleThread);
+        }
+        spawnOne = std::min(spawnOne, nowNs() - start);
+
+        for (int i = 0; i < batch; ++i)
+        {
+            uthread_block(tids[i]);
+        }
+        start = nowNs();
+        for (int i = 0; i < batch; ++i)
+        {
+            uthread_resume(tids[i]);
+        }
+        resumeOne = std::min(resumeOne, nowNs() - start);
+
+        for (int i = 0; i < batch; ++i)
+        {
+            uthread_terminate(tids[i]);
+        }
+
+        start = nowNs();
+        if (uthread_spawn_n(idleThread, batch, tids.data()) != batch)
+        {
+            failBench("spawn_n");
+        }
+        spawnMany = std::min(spawnMany, nowNs() - start);
+
+        for (int i = 0; i < batch; ++i)
+        {
+            uthread_block(tids[i]);
+        }
+        start = nowNs();
+        if (uthread_resume_many(tids.data(), batch) < 0)
+        {
+            failBench("resume_many");
+        }
+        resumeMany = std::min(resumeMany, nowNs() - start);
+
+        for (int i = 0; i < batch; ++i)
+        {
+            uthread_terminate(tids[i]);
+        }
+    }
+
+    double threads = (double)batch;
+    addResult("spawn_batch",
+              field("batch", (long long)batch) + ", " +
+              field("spawn_ns_per_thread", spawnOne / threads) + ", " +
+              field("spawn_n_ns_per_thread", spawnMany / threads));
+    addResult("resume_batch",
+              field("batch", (long long)batch) + ", " +
+              field("resume_ns_per_thread", resumeOne / threads) + ", " +
+              field("resume_many_ns_per_thread", resumeMany / threads));
+}
+
+/**
+ * Measures a job's round trip through a uthread_pool (submit, wake a parked worker, run, complete the future and
+ * resume the waiter). The main thread can't block, so it spins meanwhile and only the time it was switched out
+ * (the time the driver and the workers ran) is counted.
+ */
+static void benchPoolJobs()
+{
+    uthread_pool pool(POOL_WORKERS, POOL_CAPACITY);
+    if (pool.poolSetup() < 0)
+    {
+        failBench("pool");
+    }
+    benchPool = &pool;
+    int driver = uthread_spawn(poolDriverThread);
+    if (driver < 0)
+    {
+        failBench("pool");
+    }
+    long long switchedOutNs = 0;
+    long long last = nowNs();
+    while (!poolDriverDone)
+    {
+        long long now = nowNs();
+        if (now - last > SWITCHED_OUT_NS)
+        {
+            switchedOutNs += now - last;
+        }
+        last = now;
+    }
+    uthread_terminate(driver);
+    pool.shutdown();
+
+    if (poolJobsDone != POOL_JOBS)
+    {
+        failBench("pool");
+    }
+    addResult("pool_jobs",
+              field("workers", (long long)POOL_WORKERS) + ", " +
+              field("jobs", (long long)POOL_JOBS) + ", " +
+              field("ns_per_job", (double)switchedOutNs / POOL_JOBS));
+}
+
+static void benchContextSwitch()
+{
+    int tid = uthread_spawn(switchThread);
+    if (tid < 0)
+    {
+        failBench("context_switch");
+    }
+    switchSpin();
+    uthread_terminate(tid);
+
+    std::sort(switchSamples, switchSamples + SWITCH_SAMPLES);
+    addResult("context_switch",
+              field("samples", (long long)SWITCH_SAMPLES) + ", " +
+              field("p50_ns", percentile(switchSamples, SWITCH_SAMPLES, 50)) + ", " +
+              field("p99_ns", percentile(switchSamples, SWITCH_SAMPLES, 99)) + ", " +
+              field("max_ns", switchSamples[SWITCH_SAMPLES - 1]));
+}
+
+static void benchSleepAccuracy()
+{
+    if (uthread_spawn(sleepThread) < 0)
+    {
+        failBench("sleep_wakeup");
+    }
+    while (sleepSamplesTaken < SLEEP_SAMPLES) {}
+
+    std::sort(sleepSamples, sleepSamples + SLEEP_SAMPLES);
+    addResult("sleep_wakeup",
+              field("samples", (long long)SLEEP_SAMPLES) + ", " +
+              field("sleep_usecs", (long long)SLEEP_USECS) + ", " +
+              field("p50_late_ns", percentile(sleepSamples, SLEEP_SAMPLES, 50)) + ", " +
+              field("p99_late_ns", percentile(sleepSamples, SLEEP_SAMPLES, 99)));
+}
+
+/**
+ * Runs numThreads threads (including the main thread) for FAIRNESS_ROUNDS quantums each and reports how evenly
+ * the quantums were spread, using Jain's fairness index (1.0 is perfectly fair).
+ */
+static void benchFairness(int numThreads)
+{
+    std::string name = "fairness_" + std::to_string(numThreads);
+    if (numThreads > MAX_THREAD_NUM)
+    {
+        addResult(name, field("threads", (long long)numThreads) +
+                        ", \"skipped\": \"exceeds MAX_THREAD_NUM\"");
+        return;
+    }
+
+    std::vector<int> tids;
+    for (int i = 1; i < numThreads; ++i)
+    {
+        int tid = uthread_spawn(idleThread);
+        if (tid < 0)
+        {
+            failBench("fairness");
+        }
+        tids.push_back(tid);
+    }
+    int mainStart = uthread_get_quantums(0);
+    int end = uthread_get_total_quantums() + numThreads * FAIRNESS_ROUNDS;
+    while (uthread_get_total_quantums() < end) {}
+
+    std::vector<double> quants;
+    quants.push_back(uthread_get_quantums(0) - mainStart);
+    for (int tid : tids)
+    {
+        quants.push_back(uthread_get_quantums(tid));
+        uthread_terminate(tid);
+    }
+
+    double sum = 0, sumSquares = 0;
+    for (double q : quants)
+    {
+        sum += q;
+        sumSquares += q * q;
+    }
+    addResult(name,
+              field("threads", (long long)numThreads) + ", " +
+              field("jain_index", sum * sum / (quants.size() * sumSquares)) + ", " +
+              field("min_quantums", *std::min_element(quants.begin(), quants.end())) + ", " +
+              field("max_quantums", *std::max_element(quants.begin(), quants.end())));
+}
+
+/**
+ * Times spawning, blocking, resuming and terminating a thread.
+ * @return the average time of a round, in nanoseconds.
+ */
+static double spawnBlockResumeNs()
+{
+    long long start = nowNs();
+    for (int i = 0; i < AFFINITY_ITERATIONS; ++i)
+    {
+        int tid = uthread_spawn(idleThread);
+        if (tid < 0 || uthread_block(tid) < 0 || uthread_resume(tid) < 0 || uthread_terminate(tid) < 0)
+        {
+            failBench("affinity");
+        }
+    }
+    return (double)(nowNs() - start) / AFFINITY_ITERATIONS;
+}
+
+/**
+ * Runs the same workload with the process's own CPU affinity and pinned by uthread_set_cpu_affinity to the CPU it
+ * is running on, and then restores the affinity. Pinning only pays off when the unpinned run migrates, so on a
+ * machine with a single allowed CPU both runs are the same.
+ */
+static void benchAffinity()
+{
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) < 0)
+    {
+        failBench("affinity");
+    }
+    double unpinned = spawnBlockResumeNs();
+    if (uthread_set_cpu_affinity(sched_getcpu()) < 0)
+    {
+        failBench("affinity");
+    }
+    double pinned = spawnBlockResumeNs();
+    if (sched_setaffinity(0, sizeof(original), &original) < 0)
+    {
+        failBench("affinity");
+    }
+    addResult("affinity",
+              field("iterations", (long long)AFFINITY_ITERATIONS) + ", " +
+              field("allowed_cpus", (long long)CPU_COUNT(&original)) + ", " +
+              field("unpinned_ns_per_round", unpinned) + ", " +
+              field("pinned_ns_per_round", pinned));
+}
+
+int main(int argc, char** argv)
+{
+    int quantum = (argc > 1) ? atoi(argv[1]) : DEFAULT_QUANTUM_USECS;
+    int cpu = (argc > 2) ? atoi(argv[2]) : -1;
+    if (uthread_init(quantum) < 0)
+    {
+        return 1;
+    }
+    if (cpu >= 0 && uthread_set_cpu_affinity(cpu) < 0)
+    {
+        return 1;
+    }
+
+    benchSpawnTerminate();
+    benchBlockResume();
+    benchBatch();
+    benchPoolJobs();
+    benchContextSwitch();
+    benchSleepAccuracy();
+    if (cpu < 0)
+    {
+        benchAffinity();
+    }
+    for (int level : FAIRNESS_LEVELS)
+    {
+        benchFairness(level);
+    }
+
+    printf("{\n  \"library\": \"uthreads\",\n  \"quantum_usecs\": %d,\n  \"cpu\": %d,\n  \"max_threads\": %d,\n"
+           "  \"benchmarks\": [\n", quantum, cpu, MAX_THREAD_NUM);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        printf("    %s%s\n", results[i].c_str(), (i + 1 < results.size()) ? "," : "");
+    }
+    printf("  ]\n}\n");
+    fflush(stdout);
+    uthread_terminate(0);
+    return 0;
+}
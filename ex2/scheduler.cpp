@@ -59,6 +59,24 @@ void scheduler::addThread(int tid) {
     }
 
 }
+void scheduler::addThreads(const int *tids, int n) {
+
+    // Collect what is already scheduled once, instead of scanning _ready for every tid:
+    std::unordered_set<int> scheduled(_ready.begin(), _ready.end());
+    scheduled.insert(_running);
+
+    std::list<int> toAdd;
+    for (int i = 0; i < n; ++i) {
+        if (scheduled.insert(tids[i]).second) {
+            toAdd.push_back(tids[i]);
+        }
+    }
+    _ready.splice(_ready.end(), toAdd);
+}
+
+void scheduler::addNewThreads(const int *tids, int n) {
+    _ready.insert(_ready.end(), tids, tids + n);
+}
 
 void scheduler::printReady() {
     for(auto & iter : _ready){
@@ -5,6 +5,7 @@
 #include <list>
 #include <algorithm>
 #include <cassert>
+#include <unordered_set>
 
 static const int MAIN_THREAD_ID = 0;
 
@@ -69,6 +70,22 @@ public:
      */
      void addThread(int tid);
 
+    /**
+     * Adds the n threads in tids to the end of _ready (in order), skipping the ones that are already there or
+     * running. Makes a single pass over _ready, regardless of n.
+     * @param tids
+     * @param n
+     */
+     void addThreads(const int *tids, int n);
+
+    /**
+     * Adds the n newly spawned threads in tids to the end of _ready (in order). A new thread can't be in _ready or
+     * running yet, so unlike addThreads nothing is checked.
+     * @param tids
+     * @param n
+     */
+     void addNewThreads(const int *tids, int n);
+
      /**
     * Returns which thread in is the CPU right now.
     * @return The id of the running thread.
@@ -9,26 +9,21 @@ SleepingThreadsList::SleepingThreadsList() {
  * threads. It gets the thread's id, and the time when it needs to wake up.
  * The wakeup_tv is a struct timeval (as specified in <sys/time.h>) which
  * contains the number of seconds and microseconds since the Epoch.
- * The method keeps the list sorted by the threads' wake up time.
+ * The method keeps the list sorted by the threads' wake up time, in O(log n).
+ * If the thread is already in the list, its old entry is replaced.
 */
 void SleepingThreadsList::add(int thread_id, timeval wakeup_tv) {
 
+    remove(thread_id);
+
     wake_up_info new_thread;
     new_thread.id = thread_id;
     new_thread.awaken_tv = wakeup_tv;
 
-    if(sleeping_threads.empty()){
-        sleeping_threads.push_front(new_thread);
-    }
-    else {
-        for (deque<wake_up_info>::iterator it = sleeping_threads.begin(); it != sleeping_threads.end(); ++it){
-            if(timercmp(&it->awaken_tv, &wakeup_tv, >=)){
-                sleeping_threads.insert(it, new_thread);
-                return;
-            }
-        }
-        sleeping_threads.push_back(new_thread);
+    if ((int) entries.size() <= thread_id) {
+        entries.resize(thread_id + 1, sleeping_threads.end());
     }
+    entries[thread_id] = sleeping_threads.insert(wake_up_map::value_type(wakeup_tv, new_thread));
 }
 
 /*
@@ -36,8 +31,22 @@ void SleepingThreadsList::add(int thread_id, timeval wakeup_tv) {
  * If the list is empty, it does nothing.
 */
 void SleepingThreadsList::pop() {
-    if(!sleeping_threads.empty())
-        sleeping_threads.pop_front();
+    if(!sleeping_threads.empty()) {
+        entries[sleeping_threads.begin()->second.id] = sleeping_threads.end();
+        sleeping_threads.erase(sleeping_threads.begin());
+    }
+}
+
+/*
+ * Description: This method removes the entry of the thread with the given id, in O(1).
+ * Return value: true if the thread was in the list, false otherwise.
+*/
+bool SleepingThreadsList::remove(int thread_id) {
+    if (thread_id < 0 || (int) entries.size() <= thread_id || entries[thread_id] == sleeping_threads.end())
+        return false;
+    sleeping_threads.erase(entries[thread_id]);
+    entries[thread_id] = sleeping_threads.end();
+    return true;
 }
 
 /*
@@ -48,5 +57,5 @@ void SleepingThreadsList::pop() {
 wake_up_info* SleepingThreadsList::peek(){
     if (sleeping_threads.empty())
         return nullptr;
-    return &sleeping_threads.at(0);
+    return &sleeping_threads.begin()->second;
 }
@@ -1,7 +1,8 @@
 #ifndef SLEEPING_THREADS_LIST_H
 #define SLEEPING_THREADS_LIST_H
 
-#include <deque>
+#include <map>
+#include <vector>
 #include <sys/time.h>
 
 using namespace std;
@@ -11,9 +12,18 @@ struct wake_up_info {
     timeval awaken_tv;
 };
 
+struct earlier_tv {
+    bool operator()(const timeval& a, const timeval& b) const {
+        return timercmp(&a, &b, <);
+    }
+};
+
 class SleepingThreadsList {
 
-    deque<wake_up_info> sleeping_threads;
+    typedef multimap<timeval, wake_up_info, earlier_tv> wake_up_map;
+
+    wake_up_map sleeping_threads; // Ordered by wake up time; equal times keep the order they were added in.
+    vector<wake_up_map::iterator> entries; // The entry of every sleeping thread, by its id (end() if none).
 
 public:
 
@@ -24,7 +34,8 @@ public:
      * threads. It gets the thread's id, and the time when it needs to wake up.
      * The wakeup_tv is a struct timeval (as specified in <sys/time.h>) which
      * contains the number of seconds and microseconds since the Epoch.
-     * The method keeps the list sorted by the threads' wake up time.
+     * The method keeps the list sorted by the threads' wake up time, in O(log n).
+     * If the thread is already in the list, its old entry is replaced.
     */
     void add(int thread_id, timeval timestamp);
 
@@ -34,6 +45,12 @@ public:
     */
     void pop();
 
+    /*
+     * Description: This method removes the entry of the thread with the given id, in O(1).
+     * Return value: true if the thread was in the list, false otherwise.
+    */
+    bool remove(int thread_id);
+
     /*
      * Description: This method returns the information about the thread (id and time it needs to wake up)
      * at the top of this list without removing it from the list.
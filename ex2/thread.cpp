@@ -1,4 +1,5 @@
 #include <iostream>
+#include <sys/auxv.h>
 #include "thread.h"
 
 
@@ -44,22 +45,44 @@ address_t thread::translateAddress(address_t addr)
 
 #endif
 
+#ifndef AT_MINSIGSTKSZ
+#define AT_MINSIGSTKSZ 51
+#endif
+
+/**
+ * Signal handlers (and the context switches done inside them) run on the stack of the interrupted thread, so every
+ * stack needs room for a kernel signal frame on top of what the user asked for. On CPUs with a large register
+ * state (AVX-512, AMX) the frame alone is bigger than STACK_SIZE.
+ * @return The number of bytes to add to each thread's stack.
+ */
+static int signalFrameReserve()
+{
+    unsigned long minSigStack = getauxval(AT_MINSIGSTKSZ);
+    if (minSigStack < (unsigned long)MINSIGSTKSZ)
+    {
+        minSigStack = MINSIGSTKSZ;
+    }
+    return (int)minSigStack;
+}
+
 //-----------------Constructor & Destructor ----------------------------------------------------------------------------
 
 thread::thread()
-        :_quants(0), _isBlocked(false), _isSleeping(false) {}
+        :_stack(nullptr), _quants(0), _isBlocked(false), _isSleeping(false), _isTimedBlock(false),
+         _timedOut(false) {}
 
 
 thread::~thread()
 {
-    //will not be called foe the main thread so will not cause an error.
-    delete _stack;
+    // The main thread has no stack of its own, so _stack is nullptr for it.
+    delete[] _stack;
 }
 
 //----------------- general functionality-------------------------------------------------------------------------------
 
 int thread::setupThread(void(*f)(), int stackSize)
 {
+    stackSize += signalFrameReserve();
     try{
         _stack = new char[stackSize];
     }
@@ -99,6 +122,22 @@ bool thread::getSleep(){
     return _isSleeping;
 }
 
+void thread::setTimedBlock(bool isTimedBlock){
+    _isTimedBlock = isTimedBlock;
+}
+
+bool thread::getTimedBlock(){
+    return _isTimedBlock;
+}
+
+void thread::setTimedOut(bool timedOut){
+    _timedOut = timedOut;
+}
+
+bool thread::getTimedOut(){
+    return _timedOut;
+}
+
 void thread::updateQuants(){
     _quants++;
 }
@@ -19,8 +19,10 @@ class thread
 {
     char* _stack;
     int _quants; // holds the number of quantums this thread spent as RUNNING.
-    bool _isBlocked;
+    bool _isBlocked;    // The thread was blocked by uthread_block, and stays blocked until resumed.
     bool _isSleeping;
+    bool _isTimedBlock; // The thread sleeps until resumed or woken, or until its sleep timer expires.
+    bool _timedOut;     // The last timed block of the thread ended because its timer expired.
 
     /** translates the address of a variable, Used as a black box in our code.
      * @param addr the address of a variable.
@@ -75,6 +77,30 @@ public:
      */
     bool getSleep();
 
+    /**
+     * Updates the _isTimedBlock parameter.
+     * @param isTimedBlock
+     */
+    void setTimedBlock(bool isTimedBlock);
+
+    /**
+     * Return True iff the thread is in a timed block.
+     * @return
+     */
+    bool getTimedBlock();
+
+    /**
+     * Updates the _timedOut parameter.
+     * @param timedOut
+     */
+    void setTimedOut(bool timedOut);
+
+    /**
+     * Return True iff the last timed block of the thread ended with a timeout.
+     * @return
+     */
+    bool getTimedOut();
+
     /**
      * Returns the number of quantums in which the thread had been active.
      * @return
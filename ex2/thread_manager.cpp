@@ -81,11 +81,41 @@ int thread_manager::createThread(void (*f)())
             }
             std::cerr << "system error: couldn't insert new thread to threads list." << std::endl;
         }
+        delete newThread;
+        _usedIds.push(newTid); //recycles this tid
         return -2;
     }
     return -1;
 }
 
+int thread_manager::createThreads(void (*f)(), int n, int *tids)
+{
+    if ((int)_threads.size() + n > _maxThreadNum)
+    {
+        return -1;
+    }
+    _threads.reserve(_threads.size() + n);
+    for (int i = 0; i < n; ++i)
+    {
+        tids[i] = createThread(f);
+        if (tids[i] < 0)
+        {
+            // Either all of the threads are created or none, so the ones already created are released:
+            for (int j = 0; j < i; ++j)
+            {
+                killThread(tids[j]);
+            }
+            return -2;
+        }
+    }
+    return 0;
+}
+
+bool thread_manager::threadExists(const int tid)
+{
+    return findThread(tid) != nullptr;
+}
+
 int thread_manager::killThread(const int tid)
 {
     thread *threadWithTid = findThread(tid);
@@ -139,17 +169,64 @@ void thread_manager::putThreadToSleep(const int tid)
     threadWithTid->setSleep(true);
 }
 
+void thread_manager::putThreadToTimedBlock(const int tid)
+{
+    //no need to check for existence-
+    // made only on the running (and therefore existing) thread.
+    thread *threadWithTid = findThread(tid);
+    threadWithTid->setSleep(true);
+    threadWithTid->setTimedBlock(true);
+    threadWithTid->setTimedOut(false);
+}
+
 int thread_manager::wakeThread(const int tid)
 {
     thread *threadWithTid = findThread(tid);
     if (threadWithTid != nullptr)
     {
         threadWithTid->setSleep(false);
+        if (threadWithTid->getTimedBlock())
+        {
+            threadWithTid->setTimedBlock(false);
+            threadWithTid->setTimedOut(true);
+        }
         return 0;
     }
     return -1;
 }
 
+int thread_manager::cancelSleep(const int tid)
+{
+    thread *threadWithTid = findThread(tid);
+    if (threadWithTid != nullptr)
+    {
+        threadWithTid->setSleep(false);
+        threadWithTid->setTimedBlock(false);
+        return 0;
+    }
+    return -1;
+}
+
+bool thread_manager::isThreadTimedBlocked(const int tid)
+{
+    thread *threadWithTid = findThread(tid);
+    if (threadWithTid != nullptr)
+    {
+        return threadWithTid->getTimedBlock();
+    }
+    return false;
+}
+
+bool thread_manager::hasThreadTimedOut(const int tid)
+{
+    thread *threadWithTid = findThread(tid);
+    if (threadWithTid != nullptr)
+    {
+        return threadWithTid->getTimedOut();
+    }
+    return false;
+}
+
 bool thread_manager::isThreadAsleep(const int tid)
 {
     thread *threadWithTid = findThread(tid);
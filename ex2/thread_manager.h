@@ -69,6 +69,23 @@ public:
      */
     int createThread(void (*f)());
 
+    /**
+     * Creates n new thread objects, all running f. Either all of them are created or none.
+     * @param f : The function the threads should execute.
+     * @param n : The number of threads to create.
+     * @param tids : An array of size n, to which the new threads' tids are written.
+     * @return 0 on success.
+     * -1 if the new threads could not be created (too many threads).
+     * prints an error and returns -2 if a system error occurred.
+     */
+    int createThreads(void (*f)(), int n, int *tids);
+
+    /**
+     * @param tid: the tid of a thread.
+     * @return true if a thread with the supplied tid exists, false otherwise.
+     */
+    bool threadExists(int tid);
+
     /**
     * deletes the thread with the supplied tid, if exists.
     * @param tid: the tid of the thread we want to delete.
@@ -104,12 +121,41 @@ public:
     void putThreadToSleep(int tid);
 
     /**
+     * blocks the thread with the supplied tid (if exists) until it's resumed, or until its sleep timer expires.
+     * The thread is asleep meanwhile; it's not marked as blocked, which is kept for uthread_block.
+     * @param tid: the tid of the thread we want to block.
+     */
+    void putThreadToTimedBlock(int tid);
+
+    /**
+     * Called when the sleep timer of the thread expires. A thread in a timed block ends it as well, and is marked
+     * as timed out. A block by uthread_block stays.
      * @param tid: the tid of the thread we want to wake.
      * @return 0 if the thread exists and we succeed on waking it,
      * -1 if it does not exist.
      */
     int wakeThread(int tid);
 
+    /**
+     * Ends the sleep (or the timed block) of the thread with the supplied tid before its timer expired.
+     * The thread is not marked as timed out.
+     * @param tid: the tid of the thread we want to wake.
+     * @return 0 if the thread exists, -1 if it does not exist.
+     */
+    int cancelSleep(int tid);
+
+    /**
+     * @param tid: the tid of the thread we want to check.
+     * @return true if the thread with tid exists and is in a timed block, false otherwise.
+     */
+    bool isThreadTimedBlocked(int tid);
+
+    /**
+     * @param tid: the tid of the thread we want to check.
+     * @return true if the thread with tid exists and its last timed block ended with a timeout.
+     */
+    bool hasThreadTimedOut(int tid);
+
     /**
      * @param tid: the tid of the thread we want to check if asleep.
      * @return true if the thread with tid exists and asleep, false otherwise.
@@ -0,0 +1,333 @@
+#include "uthread_pool.h"
+#include "uthreads.h"
+
+#include <algorithm>
+#include <iostream>
+#include <signal.h>
+#include <unordered_map>
+
+//--------------Consts:
+static const int MAIN_TID = 0;
+
+//-------------Static Globals:
+/** The pool every worker thread belongs to, by the worker's tid. */
+static std::unordered_map<int, uthread_pool*> poolOfWorker;
+
+/** Workers blocked until poolSetup registers them, by tid. */
+static std::vector<int> unregisteredWorkers;
+
+//-------------Masking:
+/*
+ * The pool's state is shared by the workers and the submitting threads, so it is only touched with the library's
+ * timer signals blocked. Note that every uthreads call unmasks them when it returns, so a call to the library
+ * is always the last step of a critical section.
+ */
+static void maskSignals(){
+    sigset_t toBlock;
+    sigemptyset(&toBlock);
+    sigaddset(&toBlock, SIGVTALRM);
+    sigaddset(&toBlock, SIGALRM);
+    if(sigprocmask(SIG_BLOCK, &toBlock, nullptr) < 0){
+        std::cerr << "system error: Failed to set signal masking." << std::endl;
+        exit(1);
+    }
+}
+
+static void unmaskSignals(){
+    sigset_t toBlock;
+    sigemptyset(&toBlock);
+    sigaddset(&toBlock, SIGVTALRM);
+    sigaddset(&toBlock, SIGALRM);
+    if(sigprocmask(SIG_UNBLOCK, &toBlock, nullptr) < 0){
+        std::cerr << "system error: Failed to undo signal masking." << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * Resumes the first thread in tids that still exists, and takes it (and the terminated threads before it) out of
+ * tids. Must be called with the signals blocked, and unblocks them.
+ * @param tids: blocked threads, in the order they should be resumed.
+ */
+static void resumeFirstLive(std::vector<int>& tids)
+{
+    while (!tids.empty())
+    {
+        int tid = tids.front();
+        tids.erase(tids.begin());
+        if (uthread_exists(tid))
+        {
+            uthread_resume(tid);
+            return;
+        }
+    }
+    unmaskSignals();
+}
+
+//-------------uthread_future:
+
+uthread_future::uthread_future(): _done(false), _waiters() {}
+
+void uthread_future::_complete()
+{
+    maskSignals();
+    _done = true;
+    std::vector<int> toResume;
+    toResume.swap(_waiters);
+    unmaskSignals();
+
+    // One by one, as a waiter may have been terminated meanwhile, and uthread_resume_many would resume no one:
+    for (int tid : toResume)
+    {
+        maskSignals();
+        if (uthread_exists(tid))
+        {
+            uthread_resume(tid);
+        }
+        else
+        {
+            unmaskSignals();
+        }
+    }
+}
+
+bool uthread_future::isDone()
+{
+    maskSignals();
+    bool done = _done;
+    unmaskSignals();
+    return done;
+}
+
+void uthread_future::wait()
+{
+    int self = uthread_get_tid();
+    if (self == MAIN_TID)
+    {
+        while (!isDone()) {}
+        return;
+    }
+    maskSignals();
+    while (!_done)
+    {
+        // Still a waiter if the resume wasn't _complete's:
+        if (std::find(_waiters.begin(), _waiters.end(), self) == _waiters.end())
+        {
+            _waiters.push_back(self);
+        }
+        uthread_block(self);
+        maskSignals();
+    }
+    unmaskSignals();
+}
+
+//-------------uthread_pool:
+
+uthread_pool::uthread_pool(int numWorkers, unsigned int capacity):
+        _numWorkers(numWorkers), _capacity(capacity), _queue(), _workers(), _idle(), _parked(), _submitters(),
+        _shutdownWaiter(-1) {}
+
+uthread_pool::~uthread_pool()
+{
+    shutdown();
+}
+
+int uthread_pool::poolSetup()
+{
+    if (_numWorkers <= 0 || _capacity == 0)
+    {
+        std::cerr << "thread library error: a pool needs at least one worker and a non empty queue." << std::endl;
+        return -1;
+    }
+    _workers.resize(_numWorkers);
+    _idle.reserve(_numWorkers);
+    _parked.assign(_numWorkers, false);
+    if (uthread_spawn_n(_workerMain, _numWorkers, _workers.data()) < 0)
+    {
+        _workers.clear();
+        return -1;
+    }
+    maskSignals();
+    for (int tid : _workers)
+    {
+        poolOfWorker[tid] = this;
+    }
+
+    // Let in the workers that already ran and are blocked until they're registered:
+    std::vector<int> registered;
+    for (size_t i = 0; i < unregisteredWorkers.size();)
+    {
+        if (poolOfWorker.count(unregisteredWorkers[i]))
+        {
+            registered.push_back(unregisteredWorkers[i]);
+            unregisteredWorkers.erase(unregisteredWorkers.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    if (registered.empty())
+    {
+        unmaskSignals();
+    }
+    else
+    {
+        uthread_resume_many(registered.data(), (int)registered.size());
+    }
+    return 0;
+}
+
+void uthread_pool::_workerMain()
+{
+    // A worker may be scheduled before poolSetup registered it, in which case it blocks until the registration:
+    int self = uthread_get_tid();
+    maskSignals();
+    auto found = poolOfWorker.find(self);
+    while (found == poolOfWorker.end())
+    {
+        if (std::find(unregisteredWorkers.begin(), unregisteredWorkers.end(), self) == unregisteredWorkers.end())
+        {
+            unregisteredWorkers.push_back(self);
+        }
+        uthread_block(self);
+        maskSignals();
+        found = poolOfWorker.find(self);
+    }
+    uthread_pool* pool = found->second;
+    unmaskSignals();
+    int index = 0;
+    while (pool->_workers[index] != self)
+    {
+        ++index;
+    }
+    pool->_workerLoop(index);
+}
+
+void uthread_pool::_workerLoop(int index)
+{
+    int self = _workers[index];
+    while (true)
+    {
+        maskSignals();
+        if (_queue.empty())
+        {
+            // Park until a submitter hands us a job. A worker resumed by anyone else is still in _idle:
+            if (!_parked[index])
+            {
+                _parked[index] = true;
+                _idle.push_back(index);
+                if (_shutdownWaiter != -1 && _idle.size() == _workers.size())
+                {
+                    // The last worker to run out of jobs lets shutdown go on, and checks the queue again:
+                    std::vector<int> waiter(1, _shutdownWaiter);
+                    _shutdownWaiter = -1;
+                    resumeFirstLive(waiter);
+                    continue;
+                }
+            }
+            uthread_block(self);
+            continue;
+        }
+        if (_parked[index])
+        {
+            // Resumed by someone other than a submitter, and found a job: a submitter must not wait for us.
+            _parked[index] = false;
+            _idle.erase(std::find(_idle.begin(), _idle.end(), index));
+        }
+        job next = std::move(_queue.front());
+        _queue.pop_front();
+
+        // There is room in the queue now, let one blocked submitter in:
+        resumeFirstLive(_submitters);
+
+        next.func();
+        next.future->_complete();
+    }
+}
+
+std::shared_ptr<uthread_future> uthread_pool::trySubmit(std::function<void()> func)
+{
+    maskSignals();
+    if (_queue.size() >= _capacity)
+    {
+        unmaskSignals();
+        return nullptr;
+    }
+    std::shared_ptr<uthread_future> future = std::make_shared<uthread_future>();
+    _queue.push_back({std::move(func), future});
+
+    // Wake a parked worker, if there is one:
+    if (!_idle.empty())
+    {
+        int worker = _idle.back();
+        _idle.pop_back();
+        _parked[worker] = false;
+        uthread_resume(_workers[worker]);
+    }
+    else
+    {
+        unmaskSignals();
+    }
+    return future;
+}
+
+std::shared_ptr<uthread_future> uthread_pool::submit(std::function<void()> func)
+{
+    int self = uthread_get_tid();
+    while (true)
+    {
+        std::shared_ptr<uthread_future> future = trySubmit(func);
+        if (future != nullptr)
+        {
+            return future;
+        }
+        if (self == MAIN_TID)
+        {
+            continue; // The main thread can't block, wait for a preemption to let the workers drain the queue.
+        }
+        maskSignals();
+        if (_queue.size() < _capacity)
+        {
+            unmaskSignals();
+            continue;
+        }
+        _submitters.push_back(self);
+        uthread_block(self);
+    }
+}
+
+void uthread_pool::shutdown()
+{
+    if (_workers.empty())
+    {
+        return;
+    }
+    int self = uthread_get_tid();
+    while (true)
+    {
+        maskSignals();
+        if (_queue.empty() && _idle.size() == _workers.size())
+        {
+            unmaskSignals();
+            break;
+        }
+        if (self == MAIN_TID)
+        {
+            unmaskSignals();
+            continue; // The main thread can't block, wait for a preemption to let the workers drain the queue.
+        }
+        _shutdownWaiter = self;
+        uthread_block(self);
+    }
+
+    for (int tid : _workers)
+    {
+        maskSignals();
+        poolOfWorker.erase(tid);
+        uthread_terminate(tid);
+    }
+    _workers.clear();
+    _idle.clear();
+    _parked.clear();
+}
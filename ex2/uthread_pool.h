@@ -0,0 +1,125 @@
+#ifndef EX2_UTHREAD_POOL_H
+#define EX2_UTHREAD_POOL_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * A handle to the result of a job submitted to a uthread_pool. A future is completed once, right after its job
+ * returned, and any number of threads can wait on it.
+ * A thread that is terminated while it waits may have its tid reused by a new thread, which may then be resumed
+ * once for nothing. Every blocking call of the pool checks its condition again when it's resumed, so it doesn't
+ * mind such a resume.
+ */
+class uthread_future
+{
+    bool _done;
+    std::vector<int> _waiters; // Threads blocked in wait().
+
+    friend class uthread_pool;
+
+    /**
+     * Marks the future as done and resumes the threads waiting on it, one by one, skipping the ones that were
+     * terminated meanwhile.
+     */
+    void _complete();
+
+public:
+
+    /**
+     * Creates a future that is not done yet.
+     */
+    uthread_future();
+
+    /**
+     * Returns true iff the job of this future has already run.
+     */
+    bool isDone();
+
+    /**
+     * Waits until the job of this future has run. A thread other than the main thread is blocked (and resumed by the
+     * worker that ran the job) until the future is done. The main thread can't be blocked, so it spins until a
+     * preemption lets the job run.
+     */
+    void wait();
+};
+
+/**
+ * A pool of long-lived worker threads that run jobs from a bounded queue, so a small job doesn't pay for a thread
+ * (and its stack) of its own. Workers with nothing to do are blocked until a job is submitted.
+ * The pool is built on the uthreads API, so it must be used after uthread_init.
+ */
+class uthread_pool
+{
+    struct job
+    {
+        std::function<void()> func;
+        std::shared_ptr<uthread_future> future;
+    };
+
+    int _numWorkers;
+    unsigned int _capacity;
+    std::deque<job> _queue;
+    std::vector<int> _workers;
+    std::vector<int> _idle;       // Workers blocked on an empty queue, by their index in _workers.
+    std::vector<bool> _parked;    // Whether every worker is in _idle, so it's never added twice.
+    std::vector<int> _submitters; // Threads blocked on a full queue.
+    int _shutdownWaiter;          // A thread blocked in shutdown until the workers are done, -1 if none.
+
+    /**
+     * The loop every worker runs: takes a job, runs it and completes its future.
+     * @param index: the index of the running worker in _workers.
+     */
+    void _workerLoop(int index);
+
+    /**
+     * The entry point of the worker threads, finds the pool of the running worker and runs its loop. A worker that
+     * runs before poolSetup registered it is blocked until it does.
+     */
+    static void _workerMain();
+
+public:
+
+    /**
+     * Constructs a pool object. No thread is created until poolSetup is called.
+     * @param numWorkers: the number of worker threads.
+     * @param capacity: the maximal number of jobs waiting in the queue.
+     */
+    uthread_pool(int numWorkers, unsigned int capacity);
+
+    /**
+     * Shuts the pool down (see shutdown) if it's still running.
+     */
+    ~uthread_pool();
+
+    /**
+     * Spawns the worker threads.
+     * @return 0 on success, -1 if the workers could not be spawned.
+     */
+    int poolSetup();
+
+    /**
+     * Adds a job to the queue. When the queue is full, a thread other than the main thread is blocked until a worker
+     * takes a job out of it, and the main thread spins until it has room.
+     * @param func: the job to run.
+     * @return the future of the job.
+     */
+    std::shared_ptr<uthread_future> submit(std::function<void()> func);
+
+    /**
+     * Adds a job to the queue if it has room.
+     * @param func: the job to run.
+     * @return the future of the job, nullptr if the queue is full.
+     */
+    std::shared_ptr<uthread_future> trySubmit(std::function<void()> func);
+
+    /**
+     * Waits until every submitted job has run, and terminates the workers. A thread other than the main thread is
+     * blocked until the last worker runs out of jobs, and the main thread spins. Must not be called by a worker.
+     */
+    void shutdown();
+};
+
+#endif //EX2_UTHREAD_POOL_H
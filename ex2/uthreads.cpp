@@ -7,11 +7,11 @@
 #include "sleeping_threads_list.h"
 
 #include <signal.h>
+#include <sched.h>
 
 
 //--------------Consts:
-static const int CONVERT_CONST_SEC_TO_NSEC = 1000000000;
-static const int CONVERT_CONST_MSEC_TO_NSEC = 1000;
+static const int CONVERT_CONST_SEC_TO_USEC = 1000000;
 
 //-------------Error Massages:
 static const int sysError = -2;
@@ -46,6 +46,19 @@ static timeval calcWakUpTimeval(int usecs_to_sleep) {
     return wake_up_timeval;
 }
 
+/**
+ * Computes the number of micro-seconds left until the given time of day.
+ * @param wake_up_timeval
+ * @return The number of micro-seconds, non-positive if the time has already passed.
+ */
+static long usecsUntil(const timeval& wake_up_timeval) {
+
+    timeval now;
+    gettimeofday(&now, nullptr);
+    return (wake_up_timeval.tv_sec - now.tv_sec) * (long)CONVERT_CONST_SEC_TO_USEC +
+           (wake_up_timeval.tv_usec - now.tv_usec);
+}
+
 //------------Memory Management
 /**
  * Clears the library resources.
@@ -81,6 +94,48 @@ static void unmaskSignals(){
     }
 }
 
+//-------------Sleep Timer:
+/**
+ * Sets the real timer to the wake up time of the head of the sleeping threads list,
+ * or stops it if the list is empty.
+ */
+static void resetSleepTimer(){
+    wake_up_info* firstToWake = sleepingThreads->peek();
+    long usecs = 0; // Stops the timer.
+    if (firstToWake != nullptr) {
+        // A zero timer means "stop", so a wake up time that has already passed fires as soon as possible:
+        usecs = std::max(usecsUntil(firstToWake->awaken_tv), 1L);
+    }
+    if (rTimer->start((int)usecs) < 0) {
+        exitProg("Failed to start sleep timer.");
+    }
+}
+
+/**
+ * Adds the thread to the sleeping threads list, and resets the timer if it's the first to wake up now.
+ * @param tid
+ * @param usecs: the number of micro-seconds until the thread should wake up.
+ */
+static void addSleeper(int tid, unsigned int usecs){
+    sleepingThreads->add(tid, calcWakUpTimeval(usecs));
+    if (sleepingThreads->peek()->id == tid) {
+        resetSleepTimer();
+    }
+}
+
+/**
+ * Removes the thread's entry (if any) from the sleeping threads list, and resets the timer if it was the first
+ * to wake up.
+ * @param tid
+ */
+static void removeSleeper(int tid){
+    wake_up_info* firstToWake = sleepingThreads->peek();
+    bool wasFirst = (firstToWake != nullptr) && (firstToWake->id == tid);
+    if (sleepingThreads->remove(tid) && wasFirst) {
+        resetSleepTimer();
+    }
+}
+
 //-------------Signal Handlers:
 
 /**
@@ -111,40 +166,22 @@ static void handleQuantumTimeout(int sig){
  */
 static void handleSleepTimeout(int sig){
     if(sig == SIGALRM){
-        int totalTime = 0;
-        int inLoop = 0;
-        do{
-            ++inLoop;
-            wake_up_info* threadToAwake = sleepingThreads->peek();
+        // Awake every thread whose time has come:
+        wake_up_info* threadToAwake = sleepingThreads->peek();
+        while(threadToAwake != nullptr && usecsUntil(threadToAwake->awaken_tv) <= 0){
             int toWakeTid = threadToAwake->id;
-
-            // Awake the relevant thread:
             sleepingThreads->pop();
-            if(manager->wakeThread(toWakeTid) == 0){       // if thread exists (active, haven't been terminated while sleeping)
-                if(!(manager->isThreadBlocked(toWakeTid))) // if thread is not blocked
+            if(manager->wakeThread(toWakeTid) == 0){       // if thread exists
+                if(!(manager->isThreadBlocked(toWakeTid))) // if thread is not blocked (by uthread_block)
                 {
                     scheduler->addThread(toWakeTid);
                 }
             }
+            threadToAwake = sleepingThreads->peek();
+        }
 
-            // calculate the time until the next waking:
-            wake_up_info* nextToWake = sleepingThreads->peek();
-
-            if(nextToWake != nullptr) //if there are more sleeping threads, set a new timer for the head
-            {
-                timeval now;
-                gettimeofday(&now, nullptr);
-                timeval nextWakingTime = nextToWake->awaken_tv;
-                totalTime = (nextWakingTime.tv_sec - now.tv_sec) * CONVERT_CONST_SEC_TO_NSEC +
-                            (nextWakingTime.tv_usec - now.tv_usec) * CONVERT_CONST_MSEC_TO_NSEC;
-            } else
-            {
-                return;
-            }
-        } while(totalTime <= 0);
-
-        // Reset the timer:
-        rTimer->start(totalTime);
+        // Set the timer for the next thread to wake up:
+        resetSleepTimer();
     }
 }
 
@@ -230,12 +267,49 @@ int uthread_spawn(void (*f)()){
         unmaskSignals();
         return  -1;
     }
-    scheduler->addThread(newTid);
+    scheduler->addNewThreads(&newTid, 1);
     unmaskSignals();
     return newTid;
 }
 
 
+/*
+ * Description: This function creates n new threads, all with the entry point f, and adds them together to the
+ * end of the READY threads list (in the order of their IDs in tids). It fails without creating any thread if it
+ * would cause the number of concurrent threads to exceed the limit (MAX_THREAD_NUM), if n is not positive or if
+ * tids is null. The IDs of the new threads are written to tids, which must have room for n ints.
+ * Return value: On success, return n. On failure, return -1.
+*/
+int uthread_spawn_n(void (*f)(void), int n, int tids[])
+{
+    if (n <= 0)
+    {
+        std::cerr << libErrorSyntax << "Number of threads to spawn should be positive." << std::endl;
+        return -1;
+    }
+    if (tids == nullptr)
+    {
+        std::cerr << libErrorSyntax << "No array for the threads' IDs." << std::endl;
+        return -1;
+    }
+    maskSignals();
+    int retVal = manager->createThreads(f, n, tids);
+    if (retVal == sysError) // a sys error occurred in thread setup in manager
+    {
+        clearMem();
+        exit(1);
+    }
+    else if (retVal == -1){
+        std::cerr <<  libErrorSyntax << "Number of threads > MAX_THREAD_NUMBER." << std::endl;
+        unmaskSignals();
+        return -1;
+    }
+    scheduler->addNewThreads(tids, n);
+    unmaskSignals();
+    return n;
+}
+
+
 /*
  * Description: This function terminates the thread with ID tid and deletes
  * it from all relevant control structures. All the resources allocated by
@@ -255,6 +329,7 @@ int uthread_terminate(int tid)
 
     if(tid != 0)
     {
+        removeSleeper(tid);                                        // Frees its timer slot, if it was asleep.
         if (manager->killThread(tid) != -1)                        //If thread exists.
         {
             nextToRun = scheduler->whosNextTermination(tid);
@@ -327,6 +402,12 @@ int uthread_block(int tid)
 int uthread_resume(int tid)
 {
     maskSignals();
+    if (manager->isThreadTimedBlocked(tid))
+    {
+        // Resuming ends a timed block before its timeout:
+        removeSleeper(tid);
+        manager->cancelSleep(tid);
+    }
     if (manager->unBlockThread(tid) != -1)
     {
        if(!manager->isThreadAsleep(tid)){
@@ -341,6 +422,57 @@ int uthread_resume(int tid)
 }
 
 
+/*
+ * Description: This function resumes the n threads whose IDs are in tids, as if uthread_resume was called for
+ * each of them in order, but with a single pass over the READY threads list. If one of the IDs is not of an
+ * existing thread it is considered an error, and no thread is resumed. It is also an error if n is not positive
+ * or if tids is null.
+ * Return value: On success, return 0. On failure, return -1.
+*/
+int uthread_resume_many(const int tids[], int n)
+{
+    if (n <= 0)
+    {
+        std::cerr << libErrorSyntax << "Number of threads to resume should be positive." << std::endl;
+        return -1;
+    }
+    if (tids == nullptr)
+    {
+        std::cerr << libErrorSyntax << "No array of threads' IDs." << std::endl;
+        return -1;
+    }
+    maskSignals();
+    for (int i = 0; i < n; ++i)
+    {
+        if (!manager->threadExists(tids[i]))
+        {
+            std::cerr <<  libErrorSyntax << "Thread doesn't exit." << std::endl;
+            unmaskSignals();
+            return -1;
+        }
+    }
+
+    std::vector<int> toReady;
+    toReady.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        if (manager->isThreadTimedBlocked(tids[i]))
+        {
+            removeSleeper(tids[i]);
+            manager->cancelSleep(tids[i]);
+        }
+        manager->unBlockThread(tids[i]);
+        if (!manager->isThreadAsleep(tids[i]))
+        {
+            toReady.push_back(tids[i]);
+        }
+    }
+    scheduler->addThreads(toReady.data(), (int)toReady.size());
+    unmaskSignals();
+    return 0;
+}
+
+
 /*
  * Description: This function blocks the RUNNING thread for user specified micro-seconds (virtual time).
  * It is considered an error if the main thread (tid==0) calls this function.
@@ -352,25 +484,11 @@ int uthread_sleep(unsigned int usec)
 {
     maskSignals();
     int runningThreadTid = scheduler->getRunning();
-    wake_up_info* oldFirstToWake = sleepingThreads->peek(); // NULL if the list is empty.
 
     if(runningThreadTid != 0){ // You can't put to sleep the main process.
 
-        // Updating the sleeping threads list:
-        timeval t = calcWakUpTimeval(usec);
-        sleepingThreads->add(runningThreadTid, t);
-
-        // Reset timer:
-        wake_up_info* newFirstToWake = sleepingThreads->peek();
-        if(oldFirstToWake == nullptr) {
-            // If the list was empty before, the added thread is surly the head, and we should reset the timer:
-            rTimer->start(usec);
-        } else {
-            // If the head of the list was changed, we should update the timer according to the new head:
-            if(oldFirstToWake->id != newFirstToWake->id){
-                rTimer->start(usec);
-            }
-        }
+        // Updating the sleeping threads list (and the timer, if this thread is the next to wake up):
+        addSleeper(runningThreadTid, usec);
 
         // Now we update the manager and scheduler that the thread is sleeping:
         manager->putThreadToSleep(runningThreadTid);
@@ -390,6 +508,71 @@ int uthread_sleep(unsigned int usec)
     return -1;
 }
 
+/*
+ * Description: This function blocks the RUNNING thread until it is resumed (uthread_resume or uthread_wake),
+ * or until usec micro-seconds in real time have passed, whichever comes first. It is considered an error if the
+ * main thread (tid==0) calls this function. Immediately after the RUNNING thread transitions to the BLOCKED state
+ * a scheduling decision should be made.
+ * Return value: 0 if the thread was resumed before the timeout, 1 if the timeout expired. On failure, return -1.
+*/
+int uthread_block_timeout(unsigned int usec)
+{
+    maskSignals();
+    int runningThreadTid = scheduler->getRunning();
+
+    if(runningThreadTid != 0){ // You can't block the main process.
+
+        addSleeper(runningThreadTid, usec);
+        manager->putThreadToTimedBlock(runningThreadTid);
+        int nextToRun = scheduler->whosNextBlock(runningThreadTid);
+
+        if(vTimer->start() < 0){
+            exitProg("Failed to start _timer.");
+        }
+        totalQuants++;
+        manager->switchContext(runningThreadTid, nextToRun);
+
+        // Back here once resumed, or once the timer expired:
+        int retVal = manager->hasThreadTimedOut(runningThreadTid) ? 1 : 0;
+        unmaskSignals();
+        return retVal;
+    }
+    std::cerr <<  libErrorSyntax << "The main thread can't be blocked." << std::endl;
+    unmaskSignals();
+    return -1;
+}
+
+
+/*
+ * Description: This function ends the sleep (uthread_sleep) or the timed block (uthread_block_timeout) of the
+ * thread with ID tid before its time is over, and moves it to the READY state unless it was also blocked with
+ * uthread_block. Waking a thread that is neither sleeping nor in a timed block has no effect and is not considered
+ * an error. If no thread with ID tid exists it is considered an error.
+ * Return value: On success, return 0. On failure, return -1.
+*/
+int uthread_wake(int tid)
+{
+    maskSignals();
+    if (!manager->threadExists(tid))
+    {
+        std::cerr <<  libErrorSyntax << "Thread doesn't exit." << std::endl;
+        unmaskSignals();
+        return -1;
+    }
+    if (manager->isThreadAsleep(tid))
+    {
+        // Ends the sleep or the timed block, which are both asleep. A block by uthread_block stays:
+        removeSleeper(tid);
+        manager->cancelSleep(tid);
+        if (!manager->isThreadBlocked(tid))
+        {
+            scheduler->addThread(tid);
+        }
+    }
+    unmaskSignals();
+    return 0;
+}
+
 /*
  * Description: This function returns the thread ID of the calling thread.
  * Return value: The ID of the calling thread.
@@ -404,6 +587,26 @@ int uthread_get_tid()
 }
 
 
+/*
+ * Description: This function checks if a thread with ID tid exists. A missing thread is not considered an error,
+ * and nothing is printed. Unlike the other functions of the library, it leaves the signal mask of the caller as it
+ * was, so it can be called in the middle of a section that has the library's timer signals blocked.
+ * Return value: 1 if a thread with ID tid exists, 0 otherwise.
+*/
+int uthread_exists(int tid)
+{
+    sigset_t previous;
+    if(sigprocmask(SIG_BLOCK, &toBlock, &previous) < 0){
+        exitProg("Failed to set signal masking.");
+    }
+    int retVal = manager->threadExists(tid) ? 1 : 0;
+    if(sigprocmask(SIG_SETMASK, &previous, nullptr) < 0){
+        exitProg("Failed to undo signal masking.");
+    }
+    return retVal;
+}
+
+
 /*
  * Description: This function returns the total number of quantums since
  * the library was initialized, including the current quantum.
@@ -440,4 +643,29 @@ int uthread_get_quantums(int tid)
     std::cerr <<  libErrorSyntax << "Thread doesn't exit." << std::endl;
     unmaskSignals();
     return -1;
-}
\ No newline at end of file
+}
+
+/*
+ * Description: This function pins the kernel thread that runs all the library's threads to the CPU with the
+ * number cpu, so the threads stop migrating between cores (and sockets) and keep their caches warm. It only sets
+ * the CPU affinity: memory already allocated (and the stacks of threads spawned later, which may reuse it) stays on
+ * whichever memory node it was first touched from. It is an error to pass a negative cpu, or a cpu the process is not allowed to run on.
+ * Return value: On success, return 0. On failure, return -1.
+*/
+int uthread_set_cpu_affinity(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+        std::cerr << libErrorSyntax << "Invalid cpu number." << std::endl;
+        return -1;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) < 0)
+    {
+        std::cerr << libErrorSyntax << "Can't run on cpu " << cpu << "." << std::endl;
+        return -1;
+    }
+    return 0;
+}
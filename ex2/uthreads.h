@@ -34,6 +34,15 @@ int uthread_init(int quantum_usecs);
 */
 int uthread_spawn(void (*f)(void));
 
+/*
+ * Description: This function creates n new threads, all with the entry point f, and adds them together to the
+ * end of the READY threads list (in the order of their IDs in tids). It fails without creating any thread if it
+ * would cause the number of concurrent threads to exceed the limit (MAX_THREAD_NUM), if n is not positive or if
+ * tids is null. The IDs of the new threads are written to tids, which must have room for n ints.
+ * Return value: On success, return n. On failure, return -1.
+*/
+int uthread_spawn_n(void (*f)(void), int n, int tids[]);
+
 
 /*
  * Description: This function terminates the thread with ID tid and deletes
@@ -70,6 +79,15 @@ int uthread_block(int tid);
 */
 int uthread_resume(int tid);
 
+/*
+ * Description: This function resumes the n threads whose IDs are in tids, as if uthread_resume was called for
+ * each of them in order, but with a single pass over the READY threads list. If one of the IDs is not of an
+ * existing thread it is considered an error, and no thread is resumed. It is also an error if n is not positive
+ * or if tids is null.
+ * Return value: On success, return 0. On failure, return -1.
+*/
+int uthread_resume_many(const int tids[], int n);
+
 /*
  * Description: This function blocks the RUNNING thread for usecs micro-seconds in real time (not virtual
  * time on the cpu). It is considered an error if the main thread (tid==0) calls this function. Immediately after
@@ -79,6 +97,24 @@ int uthread_resume(int tid);
 */
 int uthread_sleep(unsigned int usec);
 
+/*
+ * Description: This function blocks the RUNNING thread until it is resumed (uthread_resume or uthread_wake),
+ * or until usec micro-seconds in real time have passed, whichever comes first. It is considered an error if the
+ * main thread (tid==0) calls this function. Immediately after the RUNNING thread transitions to the BLOCKED state
+ * a scheduling decision should be made.
+ * Return value: 0 if the thread was resumed before the timeout, 1 if the timeout expired. On failure, return -1.
+*/
+int uthread_block_timeout(unsigned int usec);
+
+/*
+ * Description: This function ends the sleep (uthread_sleep) or the timed block (uthread_block_timeout) of the
+ * thread with ID tid before its time is over, and moves it to the READY state unless it was also blocked with
+ * uthread_block. Waking a thread that is neither sleeping nor in a timed block has no effect and is not considered
+ * an error. If no thread with ID tid exists it is considered an error.
+ * Return value: On success, return 0. On failure, return -1.
+*/
+int uthread_wake(int tid);
+
 
 /*
  * Description: This function returns the thread ID of the calling thread.
@@ -87,6 +123,15 @@ int uthread_sleep(unsigned int usec);
 int uthread_get_tid();
 
 
+/*
+ * Description: This function checks if a thread with ID tid exists. A missing thread is not considered an error,
+ * and nothing is printed. Unlike the other functions of the library, it leaves the signal mask of the caller as it
+ * was, so it can be called in the middle of a section that has the library's timer signals blocked.
+ * Return value: 1 if a thread with ID tid exists, 0 otherwise.
+*/
+int uthread_exists(int tid);
+
+
 /*
  * Description: This function returns the total number of quantums since
  * the library was initialized, including the current quantum.
@@ -110,5 +155,15 @@ int uthread_get_total_quantums();
 */
 int uthread_get_quantums(int tid);
 
+
+/*
+ * Description: This function pins the kernel thread that runs all the library's threads to the CPU with the
+ * number cpu, so the threads stop migrating between cores (and sockets) and keep their caches warm. It only sets
+ * the CPU affinity: memory already allocated (and the stacks of threads spawned later, which may reuse it) stays on
+ * whichever memory node it was first touched from. It is an error to pass a negative cpu, or a cpu the process is not allowed to run on.
+ * Return value: On success, return 0. On failure, return -1.
+*/
+int uthread_set_cpu_affinity(int cpu);
+
 #endif
 
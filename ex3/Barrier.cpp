@@ -1,15 +1,26 @@
 #include "Barrier.h"
+#include "Futex.h"
+#include <climits>
 #include <cstdlib>
 #include <cstdio>
 #include <iostream>
+#include <unistd.h>
 
-Barrier::Barrier(int numThreads)
-        : count(0) , numThreads(numThreads)
+/** the number of times a waiting thread checks the barrier before it sleeps, when every thread has a CPU */
+static const int SPIN_TRIES = 256;
+
+/** the number of ints between two threads' episodes, so each is in a cache line of its own */
+static const int EPISODE_STRIDE = 64 / sizeof(int);
+
+Barrier::Barrier(int numThreads, barrier_t kind)
+        : kind(kind), count(0), generation(0), numThreads(numThreads), spinTries(0), arrived(0), futexGeneration(0),
+          sleepers(0), rounds(0), flags(nullptr), episodes(nullptr)
 {
     if(pthread_mutex_init(&mutex, NULL) != 0 || pthread_cond_init(&cv, NULL) != 0){
         std::cerr << "System Error: An error had occurred while initializing Barrier." << std::endl;
         exit(1);
     }
+    reset(numThreads, kind);
 }
 
 
@@ -23,22 +34,47 @@ Barrier::~Barrier()
         fprintf(stderr, "[[Barrier]] error on pthread_cond_destroy");
         exit(1);
     }
+    delete[] flags;
+    delete[] episodes;
 }
 
 
-void Barrier::barrier()
+void Barrier::barrier(int id)
+{
+    switch (kind)
+    {
+        case CONDITION_BARRIER:
+            conditionBarrier();
+            break;
+        case FUTEX_BARRIER:
+            futexBarrier();
+            break;
+        case DISSEMINATION_BARRIER:
+            disseminationBarrier(id);
+            break;
+    }
+}
+
+
+void Barrier::conditionBarrier()
 {
     if (pthread_mutex_lock(&mutex) != 0){
         fprintf(stderr, "[[Barrier]] error on pthread_mutex_lock");
         exit(1);
     }
     if (++count < numThreads) {
-        if (pthread_cond_wait(&cv, &mutex) != 0){
-            fprintf(stderr, "[[Barrier]] error on pthread_cond_wait");
-            exit(1);
+        // Waits for the generation to change, not for a single wake up: the wait may return spuriously, and a fast
+        // thread may arrive for the next generation before this one wakes.
+        int arrivedIn = generation;
+        while (generation == arrivedIn) {
+            if (pthread_cond_wait(&cv, &mutex) != 0){
+                fprintf(stderr, "[[Barrier]] error on pthread_cond_wait");
+                exit(1);
+            }
         }
     } else {
         count = 0;
+        ++generation;
         if (pthread_cond_broadcast(&cv) != 0) {
             fprintf(stderr, "[[Barrier]] error on pthread_cond_broadcast");
             exit(1);
@@ -49,3 +85,89 @@ void Barrier::barrier()
         exit(1);
     }
 }
+
+
+void Barrier::futexBarrier()
+{
+    // The generation is read before arriving, so the last thread can't bump it in between:
+    int arrivedIn = futexGeneration.load(std::memory_order_acquire);
+    if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == numThreads) {
+        // No thread arrives for the next generation before it sees the bump, so the counter is reset first:
+        arrived.store(0, std::memory_order_relaxed);
+        futexGeneration.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            futexWake(&futexGeneration, INT_MAX);
+        }
+        return;
+    }
+
+    for (int i = 0; i < spinTries; ++i) {
+        if (futexGeneration.load(std::memory_order_acquire) != arrivedIn) {
+            return;
+        }
+        cpuRelax();
+    }
+    // Announces the sleep before checking again: the last thread either sees the sleeper, or its bump is seen here.
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+    while (futexGeneration.load(std::memory_order_seq_cst) == arrivedIn) {
+        futexWait(&futexGeneration, arrivedIn);
+    }
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+void Barrier::disseminationBarrier(int id)
+{
+    // The flags only count up, so a thread of the next episode can't be mistaken for one of this episode:
+    int episode = ++episodes[id * EPISODE_STRIDE];
+    for (int round = 0, distance = 1; round < rounds; ++round, distance *= 2) {
+        Flag& partner = flags[((id + distance) % numThreads) * rounds + round];
+        partner.count.fetch_add(1, std::memory_order_seq_cst);
+        if (partner.sleepers.load(std::memory_order_seq_cst) > 0) {
+            futexWake(&partner.count, 1);
+        }
+
+        Flag& own = flags[id * rounds + round];
+        bool done = false;
+        for (int i = 0; i < spinTries && !done; ++i) {
+            done = own.count.load(std::memory_order_acquire) - episode >= 0;
+            cpuRelax();
+        }
+        if (!done) {
+            own.sleepers.fetch_add(1, std::memory_order_seq_cst);
+            int seen;
+            while ((seen = own.count.load(std::memory_order_seq_cst)) - episode < 0) {
+                futexWait(&own.count, seen);
+            }
+            own.sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+
+void Barrier::reset(int numThreads, barrier_t kind)
+{
+    this->kind = kind;
+    count = 0;
+    this->numThreads = numThreads;
+    arrived.store(0, std::memory_order_relaxed);
+    // A thread that spins while others have no CPU only delays the ones it waits for:
+    spinTries = (numThreads <= sysconf(_SC_NPROCESSORS_ONLN)) ? SPIN_TRIES : 0;
+
+    delete[] flags;
+    delete[] episodes;
+    flags = nullptr;
+    episodes = nullptr;
+    rounds = 0;
+    if (kind == DISSEMINATION_BARRIER) {
+        while ((1 << rounds) < numThreads) {
+            ++rounds;
+        }
+        flags = new Flag[numThreads * rounds];
+        for (int i = 0; i < numThreads * rounds; ++i) {
+            flags[i].count.store(0, std::memory_order_relaxed);
+            flags[i].sleepers.store(0, std::memory_order_relaxed);
+        }
+        episodes = new int[numThreads * EPISODE_STRIDE]();
+    }
+}
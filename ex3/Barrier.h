@@ -1,6 +1,15 @@
 #ifndef BARRIER_H
 #define BARRIER_H
 #include <pthread.h>
+#include <atomic>
+
+// the ways a barrier can make its threads wait for each other:
+// CONDITION_BARRIER - a mutex and a condition variable, every thread takes the lock.
+// FUTEX_BARRIER - a counter and a generation, the last thread to arrive bumps the generation. the others spin on it
+//                 for a while, and then sleep on it with a futex. one atomic operation per thread.
+// DISSEMINATION_BARRIER - log2(numThreads) rounds in which every thread signals a different partner and waits for
+//                         another, with no shared counter. fits high thread counts.
+enum barrier_t {CONDITION_BARRIER=0, FUTEX_BARRIER=1, DISSEMINATION_BARRIER=2};
 
 // a multiple use barrier
 
@@ -9,21 +18,55 @@ public:
     /**
      * Creates a new barrier object.
      * @param numThreads: The number of thread doing the map reduce job.
+     * @param kind: the way the threads wait.
      */
-    Barrier(int numThreads);
+    Barrier(int numThreads, barrier_t kind = FUTEX_BARRIER);
     ~Barrier();
 
     /**
      * A thread calling this meathod after doing some task will have to wait to the other threads
-     * to finish the same task.
+     * to finish the same task. A thread may call it again as soon as it returns.
+     * @param id: the calling thread's id, in [0, numThreads). Every thread must have a different id.
      */
-    void barrier();
+    void barrier(int id);
+
+    /**
+     * Prepares the barrier for another group of threads. Must not be called while a thread is waiting on it.
+     * @param numThreads: The number of threads that will use the barrier.
+     * @param kind: the way the threads will wait.
+     */
+    void reset(int numThreads, barrier_t kind);
 
 private:
+    // A flag a thread of a dissemination barrier waits on, in a cache line of its own.
+    struct Flag
+    {
+        std::atomic<int> count;    // The number of times the flag was signalled.
+        std::atomic<int> sleepers; // The number of threads sleeping on count, or going to.
+        char pad[64 - 2 * sizeof(std::atomic<int>)];
+    };
+
+    void conditionBarrier();
+    void futexBarrier();
+    void disseminationBarrier(int id);
+
+    barrier_t kind;
+
     pthread_mutex_t mutex;
     pthread_cond_t cv;
     int count;
+    int generation; // Counts the times all the threads arrived, so a waiting thread knows when it may leave.
     int numThreads;
+    int spinTries;  // The number of times a waiting thread checks the barrier before it sleeps.
+
+    std::atomic<int> arrived;
+    char pad[64];
+    std::atomic<int> futexGeneration;
+    std::atomic<int> sleepers;
+
+    int rounds;
+    Flag* flags;   // flags[id * rounds + round] is the flag thread id waits on in a round.
+    int* episodes; // episodes[id * (64 / sizeof(int))] is the number of barriers thread id has passed.
 };
 
 #endif //BARRIER_H
@@ -0,0 +1,38 @@
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include <atomic>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// the spin and sleep primitives the barrier and the reduce queue wait with. internal to the framework.
+
+/**
+ * Tells the CPU the thread is spinning.
+ */
+static inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/**
+ * Sleeps while the word is expected.
+ */
+static inline void futexWait(std::atomic<int>* word, int expected)
+{
+    // Returns early (EAGAIN) if the word changed, or on a signal (EINTR). Either way the caller checks again.
+    syscall(SYS_futex, (int*) word, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+/**
+ * Wakes up to count threads sleeping on the word.
+ */
+static inline void futexWake(std::atomic<int>* word, int count)
+{
+    syscall(SYS_futex, (int*) word, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+#endif //FUTEX_H
@@ -3,6 +3,8 @@
 
 #include <vector>  //std::vector
 #include <utility> //std::pair
+#include <cstddef> //size_t
+#include <string>  //std::string
 
 // input key and value.
 // the key, value for the map function and the MapReduceFramework
@@ -23,11 +25,29 @@ class K2 {
 public:
     virtual ~K2(){}
     virtual bool operator<(const K2 &other) const = 0;
+
+    // used only by jobs that group their keys by hash (see JobConfig::hashPartition), which must implement it.
+    // keys that are equal (neither is less than the other) must have the same hash. the default reports the
+    // missing implementation and exits.
+    virtual size_t hash() const;
+
+    // used only by jobs that sort their keys by prefix (see JobConfig::keyPrefix): the key's first 8 bytes, as a
+    // number whose order agrees with operator< (a key less than another must not have a greater prefix). keys
+    // with the same prefix are compared by operator<. the default gives all the keys the same prefix.
+    virtual unsigned long long prefix() const { return 0; }
+
+    // used only by jobs that spill to disk (see JobConfig::memoryBudget): appends the key's bytes to out, to be
+    // read back by MapReduceClient::deserializeKey.
+    virtual void serialize(std::string& out) const;
 };
 
 class V2 {
 public:
     virtual ~V2(){}
+
+    // used only by jobs that spill to disk: appends the value's bytes to out, to be read back by
+    // MapReduceClient::deserializeValue.
+    virtual void serialize(std::string& out) const;
 };
 
 // output key and value
@@ -64,6 +84,17 @@ public:
     // to output (K3, V3) pairs.
     virtual void reduce(const IntermediateVec* pairs, void* context)
     const = 0;
+
+    // used only by jobs that combine their intermediate pairs (see JobConfig::combine).
+    // gets some of the (K2, V2) pairs of a single key, emitted by the same thread, and calls
+    // emit2(K2, V2, context) to replace them with fewer pairs of the same key (usually one).
+    // like reduce, it owns the pairs it gets. the default emits the pairs unchanged.
+    virtual void combine(const IntermediateVec* pairs, void* context) const;
+
+    // used only by jobs that spill to disk (see JobConfig::memoryBudget).
+    // create a new K2 / V2 out of the bytes their serialize wrote.
+    virtual K2* deserializeKey(const char* data, size_t size) const;
+    virtual V2* deserializeValue(const char* data, size_t size) const;
 };
 
 
@@ -1,37 +1,96 @@
-//TODO: To solve the job indexing problem.
-
 #include <string>
 #include <iostream>
 #include "MapReduceFramework.h"
 #include "Barrier.h"
+#include "WorkerPool.h"
+#include "SpillRun.h"
 #include "MapReduceClient.h"
 #include <atomic>
 #include <algorithm>
 #include <pthread.h>
-#include <semaphore.h>
 #include <cassert>
+#include <fstream>
+#include <iomanip>
+#include <cerrno>
+#include <ctime>
 #include <unordered_map>
 
 //-------------------------------------------- USEFUL STRUCTS --------------------------------------------------//
 
 
+struct JobContext;
+
+/**
+ * @return the time on the monotonic clock, in nanoseconds.
+ */
+static long long nowNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/**
+ * A span of time a worker spent in a phase, in nanoseconds since its job started.
+ */
+struct PhaseSpan
+{
+    phase_t _phase;
+    long long _begin;
+    long long _end;
+};
+
 /**
- * This struct holds all parameters relevant to the thread.
+ * This struct holds all parameters relevant to the thread. The client's functions get it as their EmitContext.
  */
-struct ThreadContext
+struct ThreadContext : public EmitContext
 {
     int _id;
-    int _jid;
+    JobContext* _job;
     pthread_t _thread;
     IntermediateVec _mapRes; // Keeps the results of the map stage.
+    std::vector<IntermediateVec> _partitions; // In a hash partitioned job, the results of the map stage by reducer.
+    std::vector<unsigned long> _shuffleCuts; // Worker i shuffles _mapRes[_shuffleCuts[i], _shuffleCuts[i + 1]).
+    IntermediateVec _combineBuffer; // In a combining job, the pairs emitted by map that were not combined yet.
+    bool _combining; // True while the thread runs combine, whose pairs bypass the buffer.
+    IntermediateVec* _hotPairs; // While the thread combines a part of a hot key, where its pairs go, else nullptr.
+    OutputVec _outputRes; // The pairs emitted by the thread's reduces, moved to the job's output at its end.
+    std::vector<SpillRun*> _spills; // Sorted runs of the thread's map results that passed the memory budget.
+    // The input pairs the thread has yet to map, packed by packRange. Idle threads steal its back half.
+    std::atomic<unsigned long long> _mapRange;
+    std::vector<PhaseSpan> _spans; // The phases the thread went through, in order. The last one may be open.
+    unsigned long _emitted2;
+    unsigned long _emitted3;
+    unsigned long _groups;
+    unsigned long _comparisons;
 
     /**
      * constructs a new thread context object
      * @param tid: the thread's id
-     * @param jid : the id of the job to which the thread in connected
-     * @param threadObj: the thread
+     * @param job : the job to which the thread in connected
      */
-    ThreadContext(int tid, int jid):_id(tid), _jid(jid){}
+    ThreadContext(int tid, JobContext* job):_id(tid), _job(job), _combining(false), _hotPairs(nullptr),
+                                            _mapRange(0), _emitted2(0), _emitted3(0), _groups(0), _comparisons(0){}
+
+    /**
+     * destructs this ThreadContext, removing its spilled runs.
+     */
+    ~ThreadContext()
+    {
+        for (SpillRun* run : _spills)
+        {
+            delete run;
+        }
+    }
+};
+
+/**
+ * A pair with its key's prefix next to it, so the radix sort reads the prefixes sequentially.
+ */
+struct PrefixedPair
+{
+    unsigned long long _prefix;
+    IntermediatePair _pair;
 };
 
 /**
@@ -42,27 +101,46 @@ struct JobContext{
 
     std::vector<ThreadContext*> _contexts;
     const MapReduceClient* _client;
+    JobConfig _config;
     int _numOfWorkers;
-    long _numOfElements;
 
-    stage_t _stage;
-    int _numOfProcessedElements;
-    pthread_mutex_t _stateMutex;
+    // The job's stage and the number of elements processed in it, packed together (see packProgress) so
+    // getJobState reads a consistent pair without a lock.
+    std::atomic<unsigned long long> _progress;
+    // The number of elements to process in every stage, set before the stage starts.
+    std::atomic<unsigned long> _stageTotals[REDUCE_STAGE + 1];
 
-    bool _doneShuffling;
     bool _doneJob;
 
-    std::atomic<unsigned int> _atomicCounter;
-    std::atomic<unsigned int> _firstToArrive;
-    Barrier _barrier;
+    // The index of the next input pair to map, for an input too large for the threads' packed ranges.
+    std::atomic<unsigned long> _atomicCounter;
+    std::atomic<int> _doneShufflers;
+    std::atomic<int> _doneReducers;
+    std::atomic<bool> _cancelled; // Set by cancelJob, checked by the workers between units of work.
+    bool _skipShuffle; // Set by the splitting thread when the job was cancelled by the end of the map stage.
+    // When the job spilled, the boundaries of the workers' key ranges: keys kept by the spilled runs, so they live
+    // until the job is closed.
+    std::vector<K2*> _splitters;
 
-    const InputVec* _inputVec;
-    pthread_mutex_t _inputMutex; // Used to lock the input vector when needed.
-    std::vector<IntermediateVec> _reducingQueue;
-    sem_t _queueSizeSem;
-    pthread_mutex_t _queueMutex; //Used to lock the jobs queue
-    OutputVec* _outputVec;
-    pthread_mutex_t _outputMutex; //Used to lock the output vector
+    WorkerPool* _pool; // The pool running the job's workers, nullptr if the job has threads of its own.
+    WorkerPool::Gang* _gang;
+    JobSync* _sync; // The barrier and the reducing queue.
+
+    const InputVec* _inputVec; // nullptr when the job pulls its input from _source.
+    OutputVec* _outputVec;     // nullptr when the job pushes its output to _sink.
+    InputSource* _source;
+    OutputSink* _sink;
+    pthread_mutex_t _sourceMutex; // Serializes the calls to _source.
+    pthread_mutex_t _sinkMutex;   // Serializes the calls to _sink.
+
+    pthread_mutex_t _doneMutex;   // Locks _finished and the callback.
+    pthread_cond_t _doneCond;     // Broadcast once, when the job is done.
+    bool _finished;               // True once the job's output is complete.
+    JobCallback _callback;
+    void* _callbackArg;
+
+    long long _startNs;  // When the job started, on the monotonic clock.
+    long long _endNs;    // When the job was done.
 
 
 
@@ -70,56 +148,132 @@ struct JobContext{
       * A constructor for the JobContext struct.
       * @param jid: the job's id
       * @param client: the job's client
-      * @param inputVec : the job's input
-      * @param outputVec : the place for the job to output to.
+      * @param inputVec : the job's input, or nullptr to pull it from source.
+      * @param outputVec : the place for the job to output to, or nullptr to push it to sink.
+      * @param source : the job's input source, when it has no input vector.
+      * @param sink : the job's output sink, when it has no output vector.
       * @param multiThreadLevel: the job's multi thread level.
+      * @param config: the job's tuning knobs.
+      * @param pool: the pool to run the job's workers on, or nullptr to give them threads of their own.
       */
     JobContext(unsigned int jid, const MapReduceClient* client,
-                        const InputVec* inputVec, OutputVec* outputVec,
-                        int multiThreadLevel):
+                        const InputVec* inputVec, OutputVec* outputVec, InputSource* source, OutputSink* sink,
+                        int multiThreadLevel, const JobConfig& config, WorkerPool* pool):
                         _jid(jid),_contexts(multiThreadLevel),
-                        _client(client), _numOfWorkers(multiThreadLevel),
-                        _numOfElements(inputVec->size()),_stage(UNDEFINED_STAGE),
-                        _numOfProcessedElements(0), _doneShuffling(false), _doneJob(false),
-                        _atomicCounter(0), _firstToArrive(0), _barrier(multiThreadLevel),
-                        _inputVec(inputVec), _outputVec(outputVec),
-                        _stateMutex(PTHREAD_MUTEX_INITIALIZER),
-                        _inputMutex(PTHREAD_MUTEX_INITIALIZER),
-                        _queueMutex(PTHREAD_MUTEX_INITIALIZER),
-                        _outputMutex(PTHREAD_MUTEX_INITIALIZER)
+                        _client(client), _config(config), _numOfWorkers(multiThreadLevel),
+                        _progress(0), _doneJob(false),
+                        _atomicCounter(0), _doneShufflers(0), _doneReducers(0),
+                        _cancelled(false), _skipShuffle(false),
+                        _pool(pool), _gang(nullptr),
+                        _sync(pool ? pool->acquireSync(multiThreadLevel, config.barrierKind)
+                                   : new JobSync(multiThreadLevel, config.barrierKind)),
+                        _inputVec(inputVec),
+                        _outputVec(outputVec), _source(source), _sink(sink),
+                        _sourceMutex(PTHREAD_MUTEX_INITIALIZER), _sinkMutex(PTHREAD_MUTEX_INITIALIZER),
+                        _doneMutex(PTHREAD_MUTEX_INITIALIZER), _finished(false), _callback(nullptr),
+                        _callbackArg(nullptr), _startNs(nowNs()), _endNs(_startNs)
     {
-
-        if (sem_init(&_queueSizeSem, 0, 0))
+        // The timed waits measure their deadline on the monotonic clock, which doesn't jump with the system's time:
+        pthread_condattr_t attr;
+        if (pthread_condattr_init(&attr) != 0 || pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) != 0 ||
+            pthread_cond_init(&_doneCond, &attr) != 0)
         {
-            std::cerr << "Error using sem_init." << std::endl;
+            std::cerr << "system error: couldn't initialize the job's condition variable." << std::endl;
             exit(1);
         }
-
+        pthread_condattr_destroy(&attr);
+        _stageTotals[UNDEFINED_STAGE] = 0;
+        _stageTotals[MAP_STAGE] = inputVec ? inputVec->size() : source->sizeHint();
+        _stageTotals[REDUCE_STAGE] = 0;
     }
 
     /**
-     * destructs this JobContext.
+     * destructs this JobContext, giving its synchronization objects back to the pool.
      */
     ~JobContext()
     {
-        sem_destroy(&_queueSizeSem);
+        if (_pool)
+        {
+            if (_gang)
+            {
+                _pool->release(_gang);
+            }
+            _pool->releaseSync(_sync);
+        }
+        else
+        {
+            delete _sync;
+        }
+        pthread_cond_destroy(&_doneCond);
     }
 };
 
 
 
+/**
+ * A key whose group was split into parts. Every part is combined by the thread that pops it, and the thread that
+ * combines the last part reduces all the combined pairs.
+ */
+struct HotKey
+{
+    std::atomic<int> _partsLeft;
+    IntermediateVec _combined;
+    pthread_mutex_t _mutex; // Locks _combined.
+
+    explicit HotKey(int parts): _partsLeft(parts), _mutex(PTHREAD_MUTEX_INITIALIZER) {}
+};
+
+
+
 //----------------------------------------------- STATIC GLOBALS ------------------------------------------------//
 /** next job Index */
-static unsigned int nextIndex(0);
+static std::atomic<unsigned int> nextIndex(0);
+
+/** the process wide pool the jobs' workers run on, nullptr until initWorkerPool is called */
+static WorkerPool* workerPool = nullptr;
+
+/** locks workerPool */
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** the thread that splits the keys between the shuffling threads. should be non-negative and < numOfThreads */
+static const int splittingThread = 0;
+
+/** the number of samples taken from every sorted run per worker, when choosing the shuffle's key ranges */
+static const unsigned long SPLITTER_OVERSAMPLING = 16;
+
+/** the number of output pairs a thread pushes to a sink at once */
+static const unsigned long OUTPUT_BATCH = 4096;
 
-/** holds the library's jobs*/
-static std::unordered_map<unsigned int, JobContext*> jobs;
+/** a chunk is at most 1/GRAIN_SPLIT of a worker's fair share of the remaining input */
+static const unsigned long GRAIN_SPLIT = 4;
 
-/** locks the job's dictionary and index */
-static pthread_mutex_t jobsMutex = PTHREAD_MUTEX_INITIALIZER;
+/** a thread's range of input pairs is kept as two RANGE_SHIFT bits indices in ThreadContext::_mapRange */
+static const int RANGE_SHIFT = 32;
+static const unsigned long long RANGE_MASK = (1ULL << RANGE_SHIFT) - 1;
 
-/** should be non-negative and < numOfThreads */
-static int shufflingThread = 0;
+/** the radix sort of key prefixes sorts them a byte at a time, least significant first */
+static const int PREFIX_BYTES = 8;
+static const int RADIX_BUCKETS = 256;
+
+/** vectors shorter than this are sorted by comparing the keys, even in a job with key prefixes */
+static const unsigned long RADIX_MIN = 256;
+
+/** a larger vector is sorted by comparisons in runs of SORT_RUN pairs that are then merged, so a cancelled job
+ * stops between them */
+static const unsigned long SORT_RUN = 1 << 16;
+
+/** the names of the phases in a trace */
+static const char* PHASE_NAMES[NUM_OF_PHASES] = {"map", "sort", "barrier", "shuffle", "reduce", "output"};
+
+/** the number of key comparisons the running thread's sorts made, moved to its ThreadContext when its job ends */
+static thread_local unsigned long comparisons = 0;
+
+/** the stage is kept in the top bits of JobContext::_progress, the processed elements count in the rest */
+static const int STAGE_SHIFT = 62;
+static const unsigned long long PROCESSED_MASK = (1ULL << STAGE_SHIFT) - 1;
+
+/** spreads a key's hash before it is reduced to a partition, so the partitions' hash tables don't clash with it */
+static const unsigned long long HASH_SPREAD = 0x9E3779B97F4A7C15ULL;
 
 //---------------------------------------------- STATIC FUNCTIONS ------------------------------------------------//
 
@@ -151,15 +305,34 @@ static void unlock(pthread_mutex_t *mutex)
 }
 
 /**
- * This method updates the percentage in the jobState struct.
+ * Packs a stage and a processed elements count into a single value of JobContext::_progress.
+ */
+static unsigned long long packProgress(stage_t stage, unsigned long long processed)
+{
+    return ((unsigned long long) stage << STAGE_SHIFT) | (processed & PROCESSED_MASK);
+}
+
+/**
+ * Moves the job to a new stage, with no processed elements.
+ * @param jc: the job's context
+ * @param stage: the new stage
+ * @param total: the number of elements to process in the new stage
+ */
+static void setStage(JobContext* jc, stage_t stage, unsigned long total)
+{
+    jc->_stageTotals[stage].store(total, std::memory_order_relaxed);
+    jc->_progress.store(packProgress(stage, 0), std::memory_order_release);
+}
+
+/**
+ * This method updates the percentage in the jobState struct. Only the low bits of the packed progress change,
+ * so this is a single uncontended atomic add.
  * @param jc: the job'x context
  * @param processed: the number of processed elements to update
  */
 static void updateProcess(JobContext* jc, unsigned long processed)
 {
-    lock(&jc->_stateMutex);
-    jc->_numOfProcessedElements += processed;
-    unlock(&jc->_stateMutex);
+    jc->_progress.fetch_add(processed, std::memory_order_relaxed);
 }
 
 
@@ -175,347 +348,1569 @@ static bool intermediateComparator(const IntermediatePair& p1, const Intermediat
 }
 
 /**
- * This is the function each thread runs in the beginning of the Map-Reduce process. It handles the Map and Sort
- * stages, and locks the running thread until all of the rest have finished.
- * @param tc: A struct contains the inner state of a thread.
+ * Compares between two intermediate pairs like intermediateComparator, and counts the comparison for the job's
+ * stats. Used only by the sorts of the map results.
  */
-void mapSort(ThreadContext * tc)
+static bool sortComparator(const IntermediatePair& p1, const IntermediatePair& p2)
 {
-    JobContext *jc = jobs[tc->_jid];
-    InputPair currPair;
-    K1* currElmKey = nullptr;
-    V1* currElmVal = nullptr;
-    bool notDone = false;
-
-    // checks what is the index of the next element we should map:
-    lock(&jc->_inputMutex);
-    unsigned int old_value = (jc->_atomicCounter)++;
-
-    if(old_value < (jc->_inputVec)->size()){
-        notDone = true;
-        currPair = (*(jc->_inputVec))[old_value];
-        currElmKey = currPair.first;
-        currElmVal = currPair.second;
-    }
-    unlock(&jc->_inputMutex);
-
-    // While there are elements to map, map them and keep the results in mapRes.
-    while (notDone) {
-        (jc->_client)->map(currElmKey, currElmVal, tc);
-        updateProcess(jc, 1);
-
-        // Update JobState
-        lock(&jc->_inputMutex);
-        old_value = (jc->_atomicCounter)++;
-        if(old_value < (jc->_inputVec)->size()){
-            notDone = true;
-            currPair = (*(jc->_inputVec))[old_value];
-            currElmKey = currPair.first;
-            currElmVal = currPair.second;
-        } else{
-            notDone = false;
-        }
-        unlock(&jc->_inputMutex);
-    }
-
-    // Sorts the elements in the result of the Map stage:
-    try{
-        std::sort(tc->_mapRes.begin(), tc->_mapRes.end(), intermediateComparator);
-    }
-    catch (std::bad_alloc &e)
-    {
-        std::cerr << "System Error: Sorting map results had failed." << std::endl;
-        exit(1);
-    }
-
-    // Forces the thread to wait until all the others have finished the Sort phase.
-    jc->_barrier.barrier();
+    ++comparisons;
+    return *(p1.first) < *(p2.first);
 }
 
-
-
-
 /**
- * The shuffling functionality
- * @param tc A struct contains the inner data of a thread.
+ * Sorts pairs by their keys' prefixes with a least significant byte first radix sort, skipping the bytes all the
+ * prefixes share, and then sorts every run of equal prefixes by comparing the keys. A cancelled job stops between the
+ * passes, or leaves the runs unsorted, as the pairs are deleted unshuffled.
+ * @param jc: the job's context.
+ * @param pairs: the pairs to sort.
  */
-static void shuffle(ThreadContext* tc)
+static void radixSort(JobContext* jc, IntermediateVec& pairs)
 {
-
-    JobContext *jc = jobs[tc->_jid];
-    K2 *maxKey;
-    IntermediateVec toReduce;
-    unsigned int moreToGo = 0;
-
-    //set moreToGo & _numOfElements:
-    for (int j = 0; j < jc->_numOfWorkers; ++j)
+    unsigned long size = pairs.size();
+    std::vector<PrefixedPair> entries(size), buffer(size);
+    std::vector<unsigned long> counts(PREFIX_BYTES * RADIX_BUCKETS, 0); // The counts of every byte's values.
+    for (unsigned long i = 0; i < size; ++i)
     {
-        moreToGo += jc->_contexts[j]->_mapRes.size();
+        unsigned long long prefix = pairs[i].first->prefix();
+        entries[i] = {prefix, pairs[i]};
+        for (int byte = 0; byte < PREFIX_BYTES; ++byte)
+        {
+            ++counts[byte * RADIX_BUCKETS + ((prefix >> (byte * 8)) & (RADIX_BUCKETS - 1))];
+        }
     }
-    jc->_numOfElements = moreToGo;
 
-    while (moreToGo > 0)
+    for (int byte = 0; byte < PREFIX_BYTES; ++byte)
     {
-        // finds the key for the "toReduce" vector:
-        maxKey = nullptr;
-        for (int j = 0; j < jc->_numOfWorkers; ++j)
+        if (jc->_cancelled.load(std::memory_order_relaxed))
         {
-            if (!jc->_contexts[j]->_mapRes.empty())
-            {
-                K2 *currKey = jc->_contexts[j]->_mapRes.back().first;
-                if (maxKey == nullptr || *maxKey < *currKey)
-                {
-                    maxKey = currKey;
-                }
-            }
+            return; // pairs wasn't touched yet.
         }
-
-        //pops all elements with the key, and adds them to the "toReduce" vector:
-        for (int j = 0; j < jc->_numOfWorkers; ++j)
+        unsigned long* count = &counts[byte * RADIX_BUCKETS];
+        int shift = byte * 8;
+        if (count[(entries[0]._prefix >> shift) & (RADIX_BUCKETS - 1)] == size)
         {
-            assert (maxKey != nullptr);
-            while (!jc->_contexts[j]->_mapRes.empty() &&
-                   !(*maxKey < *(jc->_contexts[j]->_mapRes.back().first)) &&
-                   !(*(jc->_contexts[j]->_mapRes.back().first) < *maxKey))
-            {
-                try{
-                    toReduce.push_back(jc->_contexts[j]->_mapRes.back());
-                }
-                catch (std::bad_alloc &e)
-                {
-                    std::cerr << "system error: couldn't add the pair to the toReduce vector." << std::endl;
-                    exit(1);
-                }
-                jc->_contexts[j]->_mapRes.pop_back();
-            }
+            continue;
         }
-
-        //adds the vector to the queue & signal:
-        lock(&jc->_queueMutex);
-        try
+        unsigned long position = 0;
+        for (int bucket = 0; bucket < RADIX_BUCKETS; ++bucket)
         {
-            jc->_reducingQueue.push_back(toReduce);
+            unsigned long bucketSize = count[bucket];
+            count[bucket] = position;
+            position += bucketSize;
         }
-        catch (std::bad_alloc &e)
+        for (const PrefixedPair& entry : entries)
         {
-            std::cerr << "system error: couldn't add the vector to the reducing queue." << std::endl;
-            exit(1);
+            buffer[count[(entry._prefix >> shift) & (RADIX_BUCKETS - 1)]++] = entry;
         }
-        unlock(&jc->_queueMutex);
+        entries.swap(buffer);
+    }
 
-        if (sem_post(&jc->_queueSizeSem))
+    for (unsigned long begin = 0, end; begin < size; begin = end)
+    {
+        end = begin + 1;
+        while (end < size && entries[end]._prefix == entries[begin]._prefix)
         {
-            std::cerr << "Error using sem_post." << std::endl;
-            exit(1);
+            ++end;
+        }
+        // Every pair is still copied back when cancelled, as pairs is half written:
+        if (end - begin > 1 && !jc->_cancelled.load(std::memory_order_relaxed))
+        {
+            std::sort(entries.begin() + begin, entries.begin() + end,
+                      [](const PrefixedPair& p1, const PrefixedPair& p2)
+                      { return sortComparator(p1._pair, p2._pair); });
+        }
+        for (unsigned long i = begin; i < end; ++i)
+        {
+            pairs[i] = entries[i]._pair;
         }
-        moreToGo -= toReduce.size();
-        toReduce.clear();
     }
 }
 
 /**
- * The reducing functionality
- * @param tc a struct contains the inner data of a thread.
+ * Sorts intermediate pairs by key, by radix on the keys' prefixes in a job that has them.
+ * @param jc: the job's context.
+ * @param pairs: the pairs to sort.
  */
-static void reduce(ThreadContext *tc)
+static void sortPairs(JobContext* jc, IntermediateVec& pairs)
 {
-    JobContext *jc = jobs[tc->_jid];
-    while (!(jc->_doneShuffling && jc->_reducingQueue.empty()))
+    if (jc->_config.keyPrefix && pairs.size() >= RADIX_MIN)
     {
-        if (sem_wait(&jc->_queueSizeSem))
-        {
-            std::cerr << "Error using sem_wait." << std::endl;
-            exit(1);
-        }
+        radixSort(jc, pairs);
+        return;
+    }
+    if (pairs.size() <= SORT_RUN)
+    {
+        std::sort(pairs.begin(), pairs.end(), sortComparator);
+        return;
+    }
 
-        // after this thread awaken, check if there is still work to be done:
-        if (!(jc->_doneShuffling && jc->_reducingQueue.empty()))
+    // A cancelled job leaves the pairs unsorted, as they are deleted unshuffled:
+    for (unsigned long begin = 0; begin < pairs.size(); begin += SORT_RUN)
+    {
+        if (jc->_cancelled.load(std::memory_order_relaxed))
         {
-
-            lock(&jc->_queueMutex);
-
-            //critical code:
-            IntermediateVec pairs = jc->_reducingQueue.back();
-            jc->_reducingQueue.pop_back();
-
-            unlock(&jc->_queueMutex);
-
-            (jc->_client)->reduce(&pairs ,tc);
-            updateProcess(jc, pairs.size());
-
+            return;
         }
+        std::sort(pairs.begin() + begin, pairs.begin() + std::min(begin + SORT_RUN, pairs.size()),
+                  sortComparator);
     }
-    // wake them all:
-    unsigned int old_value = (jc->_firstToArrive)++;
-    if (!(old_value))
+    for (unsigned long width = SORT_RUN; width < pairs.size(); width *= 2)
     {
-        for (int i = 0 ; i < jc->_numOfWorkers ; ++i) {
-            if (sem_post(&jc->_queueSizeSem)) {
-                std::cerr << "Error using sem_post." << std::endl;
-                exit(1);
+        for (unsigned long begin = 0; begin + width < pairs.size(); begin += 2 * width)
+        {
+            if (jc->_cancelled.load(std::memory_order_relaxed))
+            {
+                return;
             }
+            std::inplace_merge(pairs.begin() + begin, pairs.begin() + begin + width,
+                               pairs.begin() + std::min(begin + 2 * width, pairs.size()), sortComparator);
         }
     }
 }
 
 /**
- * This is the function that all of the threads of a job should run in order to preform the map reduce process.
- * @param arg A struct contains the inner data of a thread.
- * @return nullptr.
+ * Hashes an intermediate key, for the hash tables of a hash partitioned job.
  */
-static void* mapReduce(void *arg)
+struct KeyHash
 {
-    auto *tc = (ThreadContext *) arg;
-    JobContext *jc = jobs[tc->_jid];
-
-    // ------mapSort:
-    mapSort(tc);
-
-    // ------shuffle:
-    if (tc->_id == shufflingThread)
+    size_t operator()(const K2* key) const
     {
-        lock(&jc->_stateMutex);
-
-        //critical code:
-
-        jc->_stage = REDUCE_STAGE;
-        jc->_numOfProcessedElements = 0;
-
-        unlock(&jc->_stateMutex);
-        shuffle(tc);
-        jc->_doneShuffling = true;
+        return key->hash();
     }
-    // ------reduce:
+};
 
-    reduce(tc);
+/**
+ * Compares two intermediate keys for equality, for the hash tables of a hash partitioned job.
+ */
+struct KeyEqual
+{
+    bool operator()(const K2* k1, const K2* k2) const
+    {
+        return !(*k1 < *k2) && !(*k2 < *k1);
+    }
+};
 
-    return nullptr;
+/**
+ * @return the partition of a key in a hash partitioned job.
+ * @param key: An intermediate key.
+ * @param numOfPartitions: the number of partitions.
+ */
+static unsigned long partitionOf(const K2* key, unsigned long numOfPartitions)
+{
+    return (((unsigned long long) key->hash() * HASH_SPREAD) >> 32) % numOfPartitions;
 }
 
 /**
- * This function creates the mapping threads and activate them.
- * @param jc A struct contains the inner data of a job.
+ * Compares between two output pairs.
+ * @param p1: An object of an output type.
+ * @param p2: An object of an output type.
+ * @return: 1 if p2 > p1, and zero otherwise.
  */
-static void initThreads(JobContext* jc) {
-
-    lock(&jc->_stateMutex);
-    jc->_stage = MAP_STAGE;
-    unlock(&jc->_stateMutex);
-
-    for (int i = 0; i < jc->_numOfWorkers; ++i) {
-        //Initialize Threads contexts:
-        auto *tc = new ThreadContext(i, jc->_jid);
-        (jc->_contexts)[i] = tc;
-
-        if (pthread_create(&tc->_thread, nullptr, mapReduce, tc))
-        {
-            std::cerr << "Error using pthread_create, on thread " << i << std::endl;
-            exit(1);
-        }
-    }
+static bool outputComparator(const OutputPair& p1, const OutputPair& p2)
+{
+    return *(p1.first) < *(p2.first);
 }
 
-//--------------------------------------------------PUBLIC METHODS--------------------------------------------------//
-
 /**
- * This function produces a (K2*,V2*) pair.The context can be used to get pointers into the framework’s variables and
- * data structures.
- * @param key: The key of an intermediate element.
- * @param value: The value of an intermediate element.
- * @param context: The context of the calling thread.
+ * Pulls the next batch of input pairs from the job's source.
+ * @param jc: the job's context.
+ * @param batch: an empty vector, filled with the batch.
+ * @return false if the input is over.
  */
-void emit2(K2 *key, V2 *value, void *context) {
-    // Converting context to the right type:
-    auto *tc = (ThreadContext *) context;
-
-    // Inserting the map result to mapRes:
-    try{
-        tc->_mapRes.push_back(IntermediatePair(key, value));
+static bool pullBatch(JobContext* jc, InputVec& batch)
+{
+    lock(&jc->_sourceMutex);
+    bool pulled = false;
+    try
+    {
+        pulled = jc->_source->nextBatch(batch, std::max(1U, jc->_config.mapGrain)) || !batch.empty();
     }
     catch (std::bad_alloc &e)
     {
-        std::cerr << "system error: couldn't add to the IntermediatePairs vector." << std::endl;
+        std::cerr << "system error: couldn't read the next input batch." << std::endl;
         exit(1);
     }
+    unlock(&jc->_sourceMutex);
+    return pulled;
 }
 
 /**
- * This function produces a (K3*,V3*) pair.The context can be used to get pointers into the framework’s variables and
- * data structures.
- * @param key: The key of an output element.
- * @param value: The value of an output element.
- * @param context: The context of the calling thread.
+ * @return true if the job has an empty input vector, in which case it is done as soon as it starts.
  */
-void emit3(K3 *key, V3 *value, void *context) {
-    auto *tc = (ThreadContext *) context;
-    JobContext *jc = jobs[tc->_jid];
-
-    // Converting context to the right type:
-    lock(&jc->_outputMutex);
+static bool isEmptyJob(JobContext* jc)
+{
+    return jc->_inputVec != nullptr && jc->_inputVec->empty();
+}
 
-    //critical code:
-    try{
-        jc->_outputVec->push_back(OutputPair(key, value));
-    }
-    catch (std::bad_alloc &e)
+/**
+ * Ends the thread's current phase, if it has one, and starts another.
+ * @param tc: A struct contains the inner state of a thread.
+ * @param phase: the phase to start.
+ */
+static void beginPhase(ThreadContext* tc, phase_t phase)
+{
+    long long now = nowNs() - tc->_job->_startNs;
+    if (!tc->_spans.empty() && tc->_spans.back()._end < 0)
     {
-        std::cerr << "system error: couldn't to the output vector." << std::endl;
-        exit(1);
+        tc->_spans.back()._end = now;
     }
-    unlock(&jc->_outputMutex);
+    tc->_spans.push_back({phase, now, -1});
 }
 
-void waitForJob(JobHandle job) {
-    auto *jc = (JobContext *) job;
-
-    // If there are no elements to proceed the job is as good as done, and needs no waiting for.
-    // If we called wait once (hence the job is done: don't wait)
-    if(!jc->_inputVec->empty() && !jc->_doneJob){
-        jc->_doneJob = true;
-        for (int i = 0; i < jc->_numOfWorkers; ++i) {
-            if(pthread_join(jc->_contexts[i]->_thread, nullptr)){
-                std::cerr << "Error using pthread_join." << i << std::endl;
-                exit(1);
-            }
-        }
+/**
+ * Ends the thread's current phase, and adds up its counters. Called before the thread's part of the job is done.
+ * @param tc: A struct contains the inner state of a thread.
+ */
+static void endPhase(ThreadContext* tc)
+{
+    if (!tc->_spans.empty() && tc->_spans.back()._end < 0)
+    {
+        tc->_spans.back()._end = nowNs() - tc->_job->_startNs;
     }
+    tc->_comparisons += comparisons;
+    comparisons = 0;
 }
 
 /**
- * this function gets a job handle and check for his current state in a given JobState struct.
- * @param job: A pointer to the job struct.
- * @param state: A pointer to a state object to be filled with the current job's state.
+ * @return true if the job was cancelled, in which case its workers stop at the next unit of work.
  */
-void getJobState(JobHandle job, JobState *state) {
-    auto *jc = (JobContext *) job;
-    if(!(jc->_inputVec->empty())){
-        lock(&jc->_stateMutex);
-
-        //critical code:
-        state->percentage = (float)(jc->_numOfProcessedElements * (100.0 / jc->_numOfElements));
-        state->stage = jc->_stage;
+static bool isCancelled(JobContext* jc)
+{
+    return jc->_cancelled.load(std::memory_order_relaxed);
+}
 
-        unlock(&jc->_stateMutex);
+/**
+ * Deletes intermediate pairs that won't be reduced, as the job was cancelled.
+ */
+static void deletePairs(IntermediateVec::const_iterator begin, IntermediateVec::const_iterator end)
+{
+    for (; begin != end; ++begin)
+    {
+        delete begin->first;
+        delete begin->second;
     }
+}
 
-    else {
-        // If there are no elements to proceed, the job is good as done:
-        lock(&jc->_stateMutex);
-
-        //critical code:
-        state->percentage = 100;
-        state->stage = REDUCE_STAGE;
-
-        unlock(&jc->_stateMutex);
+/**
+ * Deletes the pairs a cancelled job's thread emitted in the map stage, that were not shuffled.
+ * @param tc: A struct contains the inner state of a thread.
+ */
+static void dropMapResults(ThreadContext* tc)
+{
+    deletePairs(tc->_combineBuffer.begin(), tc->_combineBuffer.end());
+    tc->_combineBuffer.clear();
+    deletePairs(tc->_mapRes.begin(), tc->_mapRes.end());
+    tc->_mapRes.clear();
+    for (IntermediateVec& partition : tc->_partitions)
+    {
+        deletePairs(partition.begin(), partition.end());
+        partition.clear();
     }
-
 }
 
 /**
- * Releasing all resources of a job, after the job was done. After using this function the jobHandle will be invalid.
- * @param job: A pointer to the job's context.
+ * Deletes output pairs a cancelled job won't output.
  */
-void closeJobHandle(JobHandle job) {
+static void dropOutput(OutputVec& pairs)
+{
+    for (OutputPair& pair : pairs)
+    {
+        delete pair.first;
+        delete pair.second;
+    }
+    pairs.clear();
+}
+
+/**
+ * Packs a range of input pairs [begin, end) into a single value of ThreadContext::_mapRange.
+ */
+static unsigned long long packRange(unsigned long begin, unsigned long end)
+{
+    return ((unsigned long long) begin << RANGE_SHIFT) | end;
+}
+
+/**
+ * @return true if the job's input is small enough to be split into the threads' packed ranges.
+ */
+static bool hasMapRanges(JobContext* jc)
+{
+    return jc->_inputVec->size() <= RANGE_MASK;
+}
+
+/**
+ * Claims the next chunk of input pairs to map from the job's shared counter, with a single atomic operation. The
+ * chunk size adapts to the remaining work: it is at most mapGrain, and shrinks as the input runs out so the workers
+ * finish together.
+ * @param jc: the job's context.
+ * @param begin: set to the index of the first pair of the chunk.
+ * @param end: set to the index after the last pair of the chunk.
+ * @return false if there is no input left to claim.
+ */
+static bool claimShared(JobContext* jc, unsigned long& begin, unsigned long& end)
+{
+    unsigned long size = jc->_inputVec->size();
+    unsigned long seen = jc->_atomicCounter.load(std::memory_order_relaxed);
+    if (seen >= size)
+    {
+        return false;
+    }
+    unsigned long grain = (size - seen) / (jc->_numOfWorkers * GRAIN_SPLIT);
+    grain = std::max(1UL, std::min(grain, (unsigned long)jc->_config.mapGrain));
+
+    begin = jc->_atomicCounter.fetch_add(grain);
+    if (begin >= size)
+    {
+        return false;
+    }
+    end = std::min(begin + grain, size);
+    return true;
+}
+
+/**
+ * Moves the back half of the largest range of the other threads to the thread's own range, which is empty.
+ * Only the thread itself fills its range, so once it is empty no one else changes it, and it may simply be stored.
+ * @param tc: A struct contains the inner state of a thread.
+ * @return false if all the other threads' ranges are empty.
+ */
+static bool stealRange(ThreadContext* tc)
+{
+    JobContext *jc = tc->_job;
+    while (true)
+    {
+        ThreadContext* victim = nullptr;
+        unsigned long long range = 0;
+        unsigned long most = 0;
+        for (ThreadContext* other : jc->_contexts)
+        {
+            unsigned long long otherRange = other->_mapRange.load(std::memory_order_acquire);
+            unsigned long left = (otherRange & RANGE_MASK) - (otherRange >> RANGE_SHIFT);
+            if (other != tc && left > most)
+            {
+                victim = other;
+                range = otherRange;
+                most = left;
+            }
+        }
+        if (victim == nullptr)
+        {
+            return false;
+        }
+
+        unsigned long begin = range >> RANGE_SHIFT, end = range & RANGE_MASK;
+        unsigned long middle = begin + (end - begin) / 2;
+        if (victim->_mapRange.compare_exchange_weak(range, packRange(begin, middle), std::memory_order_acq_rel))
+        {
+            tc->_mapRange.store(packRange(middle, end), std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+/**
+ * Claims the next chunk of input pairs to map from the front of the thread's range, stealing a range from another
+ * thread when it runs out. The chunk is at most mapGrain, and at most 1/GRAIN_SPLIT of the range, so a busy
+ * thread leaves most of its range to be stolen.
+ * @param tc: A struct contains the inner state of a thread.
+ * @param begin: set to the index of the first pair of the chunk.
+ * @param end: set to the index after the last pair of the chunk.
+ * @return false if there is no input left to claim.
+ */
+static bool claimChunk(ThreadContext* tc, unsigned long& begin, unsigned long& end)
+{
+    JobContext *jc = tc->_job;
+    if (!hasMapRanges(jc))
+    {
+        return claimShared(jc, begin, end);
+    }
+
+    unsigned long long range = tc->_mapRange.load(std::memory_order_acquire);
+    while (true)
+    {
+        begin = range >> RANGE_SHIFT;
+        unsigned long last = range & RANGE_MASK;
+        if (begin == last)
+        {
+            if (!stealRange(tc))
+            {
+                return false;
+            }
+            range = tc->_mapRange.load(std::memory_order_acquire);
+            continue;
+        }
+        unsigned long grain = std::max(1UL, std::min((last - begin) / GRAIN_SPLIT,
+                                                     (unsigned long)jc->_config.mapGrain));
+        end = begin + grain;
+        // Fails only if a thief took the back of the range, which reloads it:
+        if (tc->_mapRange.compare_exchange_weak(range, packRange(end, last), std::memory_order_acq_rel))
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * Sorts the thread's map results and moves them to a temporary file, when they pass the thread's share of the
+ * job's memory budget.
+ * @param tc: A struct contains the inner state of a thread.
+ */
+static void spill(ThreadContext* tc)
+{
+    try{
+        sortPairs(tc->_job, tc->_mapRes);
+        tc->_spills.push_back(new SpillRun(tc->_mapRes));
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "System Error: Spilling map results had failed." << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * Runs the client's combine on every group of pairs with the same key in a sorted vector. The combined pairs are
+ * emitted to the thread's map results.
+ * @param tc: A struct contains the inner state of a thread.
+ * @param pairs: The pairs to combine, sorted by key. Emptied.
+ */
+static void combineSorted(ThreadContext* tc, IntermediateVec& pairs)
+{
+    JobContext *jc = tc->_job;
+    IntermediateVec group;
+    tc->_combining = true;
+    for (unsigned long begin = 0, end; begin < pairs.size(); begin = end)
+    {
+        end = begin + 1;
+        while (end < pairs.size() && !intermediateComparator(pairs[begin], pairs[end]))
+        {
+            ++end;
+        }
+        group.assign(pairs.begin() + begin, pairs.begin() + end);
+        (jc->_client)->combine(&group, static_cast<EmitContext*>(tc));
+    }
+    tc->_combining = false;
+    pairs.clear();
+}
+
+/**
+ * Combines the pairs in the thread's combine buffer. The buffer is small enough to be sorted in the cache, so
+ * this is much cheaper than sorting every pair map emits.
+ * @param tc: A struct contains the inner state of a thread.
+ */
+static void flushCombineBuffer(ThreadContext* tc)
+{
+    try{
+        sortPairs(tc->_job, tc->_combineBuffer);
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "System Error: Sorting map results had failed." << std::endl;
+        exit(1);
+    }
+    combineSorted(tc, tc->_combineBuffer);
+}
+
+/**
+ * This is the function each thread runs in the beginning of the Map-Reduce process. It handles the Map and Sort
+ * stages, and locks the running thread until all of the rest have finished.
+ * @param tc: A struct contains the inner state of a thread.
+ */
+void mapSort(ThreadContext * tc)
+{
+    JobContext *jc = tc->_job;
+    unsigned long begin, end;
+
+    // While there are elements to map, map them and keep the results in mapRes.
+    if (jc->_source)
+    {
+        InputVec batch, inputs;
+        while (!isCancelled(jc) && pullBatch(jc, batch)) {
+            const InputVec& toMap = jc->_source->expand(batch, inputs) ? inputs : batch;
+            for (const InputPair& currPair : toMap) {
+                (jc->_client)->map(currPair.first, currPair.second, static_cast<EmitContext*>(tc));
+            }
+            updateProcess(jc, toMap.size());
+            lock(&jc->_sourceMutex);
+            jc->_source->doneWith(batch);
+            unlock(&jc->_sourceMutex);
+            batch.clear();
+            inputs.clear();
+        }
+    }
+    else
+    {
+        while (!isCancelled(jc) && claimChunk(tc, begin, end)) {
+            for (unsigned long i = begin; i < end; ++i) {
+                const InputPair& currPair = (*(jc->_inputVec))[i];
+                (jc->_client)->map(currPair.first, currPair.second, static_cast<EmitContext*>(tc));
+            }
+            updateProcess(jc, end - begin);
+        }
+    }
+    beginPhase(tc, SORT_PHASE);
+    if (isCancelled(jc))
+    {
+        dropMapResults(tc);
+        beginPhase(tc, BARRIER_PHASE);
+        jc->_sync->barrier.barrier(tc->_id);
+        return;
+    }
+    if (jc->_config.combine)
+    {
+        flushCombineBuffer(tc);
+    }
+
+    // Sorts the elements in the result of the Map stage, unless they are grouped by hash:
+    try{
+        if (!jc->_config.hashPartition)
+        {
+            sortPairs(jc, tc->_mapRes);
+        }
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "System Error: Sorting map results had failed." << std::endl;
+        exit(1);
+    }
+
+    // Combines the pairs of every key across the buffers. combine keeps the keys, so the results stay sorted:
+    if (jc->_config.combine && !jc->_config.hashPartition && !isCancelled(jc))
+    {
+        IntermediateVec sorted;
+        sorted.swap(tc->_mapRes);
+        combineSorted(tc, sorted);
+    }
+
+    // Forces the thread to wait until all the others have finished the Sort phase.
+    beginPhase(tc, BARRIER_PHASE);
+    jc->_sync->barrier.barrier(tc->_id);
+}
+
+
+
+
+/**
+ * Reduces a group of pairs with the same key.
+ * @param tc: A struct contains the inner data of the reducing thread.
+ * @param group: the pairs to reduce.
+ */
+static void reduceGroup(ThreadContext* tc, const IntermediateVec& group)
+{
+    JobContext *jc = tc->_job;
+    if (isCancelled(jc))
+    {
+        deletePairs(group.begin(), group.end());
+        return;
+    }
+    (jc->_client)->reduce(&group, static_cast<EmitContext*>(tc));
+    updateProcess(jc, group.size());
+}
+
+/**
+ * Combines a part of a hot key's group, and reduces all of the key's combined pairs if it is the last part.
+ * @param tc: A struct contains the inner data of the reducing thread.
+ * @param part: the pairs to combine.
+ * @param hotKey: the key the part belongs to. Deleted by the thread of the last part.
+ */
+static void reducePart(ThreadContext* tc, IntermediateVec& part, HotKey* hotKey)
+{
+    JobContext *jc = tc->_job;
+    IntermediateVec combined;
+    if (isCancelled(jc))
+    {
+        deletePairs(part.begin(), part.end());
+    }
+    else
+    {
+        tc->_hotPairs = &combined;
+        (jc->_client)->combine(&part, static_cast<EmitContext*>(tc));
+        tc->_hotPairs = nullptr;
+        updateProcess(jc, part.size());
+    }
+
+    lock(&hotKey->_mutex);
+    try{
+        hotKey->_combined.insert(hotKey->_combined.end(), combined.begin(), combined.end());
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "system error: couldn't combine a part of a hot key." << std::endl;
+        exit(1);
+    }
+    unlock(&hotKey->_mutex);
+
+    // The decrement orders the other parts' inserts before the reduce:
+    if (--(hotKey->_partsLeft) == 0)
+    {
+        if (isCancelled(jc))
+        {
+            deletePairs(hotKey->_combined.begin(), hotKey->_combined.end());
+        }
+        else
+        {
+            (jc->_client)->reduce(&hotKey->_combined, static_cast<EmitContext*>(tc));
+        }
+        delete hotKey;
+    }
+}
+
+/**
+ * Moves a vector of pairs to the reducing queue. When the queue is full the shuffling thread reduces the vector
+ * itself, instead of waiting for a reducer.
+ * @param tc: A struct contains the inner data of the shuffling thread.
+ * @param group: the vector to add. Left empty.
+ * @param hotKey: the split key the vector is a part of, nullptr for a whole group.
+ */
+static void pushGroup(ThreadContext* tc, IntermediateVec& group, HotKey* hotKey)
+{
+    if (tc->_job->_sync->queue.tryPush(group, hotKey))
+    {
+        return;
+    }
+    if (hotKey)
+    {
+        reducePart(tc, group, hotKey);
+    }
+    else
+    {
+        reduceGroup(tc, group);
+    }
+    group.clear();
+}
+
+/**
+ * Moves a vector of pairs with the same key to the reducing queue. In a combining job, a group larger than the job's
+ * hotKeySplit is split into parts, up to one per idle reducer, that are reduced by several reducers.
+ * @param tc: A struct contains the inner data of the shuffling thread.
+ * @param group: the vector to add. Left empty.
+ */
+static void queueForReduce(ThreadContext* tc, IntermediateVec& group)
+{
+    JobContext *jc = tc->_job;
+    ++tc->_groups;
+    unsigned long threshold = jc->_config.hotKeySplit;
+    if (threshold == 0 || !jc->_config.combine || group.size() <= threshold || jc->_numOfWorkers == 1)
+    {
+        pushGroup(tc, group, nullptr);
+        return;
+    }
+
+    // A split costs a combine of every part, and pays only if the parts are taken right away. With the reducers
+    // busy on other groups, the parts would wait in the queue behind them, so the group is split only among the
+    // reducers that are idle now:
+    int parts = (int) std::min(std::min((unsigned long) jc->_numOfWorkers, (group.size() + threshold - 1) / threshold),
+                               (unsigned long) jc->_sync->queue.idleReducers());
+    if (parts < 2)
+    {
+        pushGroup(tc, group, nullptr);
+        return;
+    }
+    auto* hotKey = new HotKey(parts);
+    IntermediateVec part;
+    for (int i = 0; i < parts; ++i)
+    {
+        try{
+            part.assign(group.begin() + group.size() * i / parts, group.begin() + group.size() * (i + 1) / parts);
+        }
+        catch (std::bad_alloc &e)
+        {
+            std::cerr << "system error: couldn't split a hot key." << std::endl;
+            exit(1);
+        }
+        pushGroup(tc, part, hotKey);
+    }
+    group.clear();
+}
+
+/**
+ * Called by every worker when it has queued all of its keys. The last worker to finish shuffling closes the
+ * queue, to let the reducers know no more groups are coming.
+ * @param jc: the job's context.
+ */
+static void doneShuffling(JobContext* jc)
+{
+    if (++(jc->_doneShufflers) == jc->_numOfWorkers)
+    {
+        jc->_sync->queue.close();
+    }
+}
+
+/**
+ * Splits the key space into one range per worker, using keys sampled evenly from every sorted map result, and
+ * cuts every map result at the ranges' boundaries. Equal keys always fall in the same range, and when the keys are
+ * few some workers get an empty one. The cuts are all made here, before any worker starts to reduce (and may
+ * delete the keys).
+ * @param jc: the job's context.
+ */
+static void splitKeys(JobContext* jc)
+{
+    unsigned long samplesPerRun = (unsigned long) jc->_numOfWorkers * SPLITTER_OVERSAMPLING;
+    IntermediateVec samples;
+    for (ThreadContext* tc : jc->_contexts)
+    {
+        const IntermediateVec& run = tc->_mapRes;
+        unsigned long step = std::max(1UL, run.size() / samplesPerRun);
+        for (unsigned long i = step / 2; i < run.size(); i += step)
+        {
+            samples.push_back(run[i]);
+        }
+    }
+
+    // The readers of spilled runs use the splitters all through the shuffle, so when the job spilled they are taken
+    // only out of the keys the runs keep. There are enough of them, as every run has passed the memory budget:
+    bool spilled = false;
+    for (ThreadContext* tc : jc->_contexts)
+    {
+        spilled = spilled || !tc->_spills.empty();
+    }
+    if (spilled)
+    {
+        samples.clear();
+        for (ThreadContext* tc : jc->_contexts)
+        {
+            for (SpillRun* run : tc->_spills)
+            {
+                for (const SpillRun::IndexEntry& entry : run->index())
+                {
+                    samples.push_back(IntermediatePair(entry.key, nullptr));
+                }
+            }
+        }
+    }
+    std::sort(samples.begin(), samples.end(), intermediateComparator);
+
+    IntermediateVec splitters;
+    for (int i = 1; i < jc->_numOfWorkers && !samples.empty(); ++i)
+    {
+        const IntermediatePair& candidate = samples[i * samples.size() / jc->_numOfWorkers];
+        if (splitters.empty() || intermediateComparator(splitters.back(), candidate))
+        {
+            splitters.push_back(candidate);
+            if (spilled)
+            {
+                jc->_splitters.push_back(candidate.first);
+            }
+        }
+    }
+
+    for (ThreadContext* tc : jc->_contexts)
+    {
+        const IntermediateVec& run = tc->_mapRes;
+        tc->_shuffleCuts.assign(jc->_numOfWorkers + 1, run.size());
+        tc->_shuffleCuts[0] = 0;
+        for (unsigned long i = 0; i < splitters.size(); ++i)
+        {
+            tc->_shuffleCuts[i + 1] = std::lower_bound(run.begin() + tc->_shuffleCuts[i], run.end(), splitters[i],
+                                                       intermediateComparator) - run.begin();
+        }
+    }
+}
+
+/**
+ * The shuffling functionality: merges this worker's key range out of all the sorted map results, and queues
+ * a vector for every key in it. All the workers shuffle their ranges at the same time.
+ * @param tc A struct contains the inner data of a thread.
+ */
+static void shuffle(ThreadContext* tc)
+{
+    JobContext *jc = tc->_job;
+    IntermediateVec toReduce;
+
+    // This worker's slice of every run, and where the current key ends in it:
+    std::vector<IntermediateVec::const_iterator> next, last, keyEnd(jc->_numOfWorkers);
+    for (ThreadContext* worker : jc->_contexts)
+    {
+        next.push_back(worker->_mapRes.begin() + worker->_shuffleCuts[tc->_id]);
+        last.push_back(worker->_mapRes.begin() + worker->_shuffleCuts[tc->_id + 1]);
+    }
+
+    // And of every spilled run:
+    std::vector<SpillReader*> readers;
+    auto numOfSplitters = (int) jc->_splitters.size();
+    if (tc->_id <= numOfSplitters)
+    {
+        const K2* low = (tc->_id == 0) ? nullptr : jc->_splitters[tc->_id - 1];
+        const K2* high = (tc->_id == numOfSplitters) ? nullptr : jc->_splitters[tc->_id];
+        for (ThreadContext* worker : jc->_contexts)
+        {
+            for (SpillRun* run : worker->_spills)
+            {
+                readers.push_back(new SpillReader(*run, *(jc->_client), low, high));
+            }
+        }
+    }
+
+    while (!isCancelled(jc))
+    {
+        // finds the key for the "toReduce" vector:
+        K2 *minKey = nullptr;
+        for (int j = 0; j < jc->_numOfWorkers; ++j)
+        {
+            if (next[j] != last[j] && (minKey == nullptr || *(next[j]->first) < *minKey))
+            {
+                minKey = next[j]->first;
+            }
+        }
+        for (SpillReader* reader : readers)
+        {
+            if (reader->key() != nullptr && (minKey == nullptr || *(reader->key()) < *minKey))
+            {
+                minKey = reader->key();
+            }
+        }
+        if (minKey == nullptr)
+        {
+            break;
+        }
+
+        //takes all elements with the key, and moves them to the "toReduce" vector, sized once:
+        unsigned long groupSize = 0;
+        for (int j = 0; j < jc->_numOfWorkers; ++j)
+        {
+            keyEnd[j] = next[j];
+            while (keyEnd[j] != last[j] && !(*minKey < *(keyEnd[j]->first)))
+            {
+                ++keyEnd[j];
+            }
+            groupSize += keyEnd[j] - next[j];
+        }
+        try{
+            toReduce.reserve(groupSize);
+            for (int j = 0; j < jc->_numOfWorkers; ++j)
+            {
+                toReduce.insert(toReduce.end(), next[j], keyEnd[j]);
+                next[j] = keyEnd[j];
+            }
+            for (SpillReader* reader : readers)
+            {
+                while (reader->key() != nullptr && !(*minKey < *(reader->key())))
+                {
+                    toReduce.push_back(reader->take());
+                }
+            }
+        }
+        catch (std::bad_alloc &e)
+        {
+            std::cerr << "system error: couldn't add the pair to the toReduce vector." << std::endl;
+            exit(1);
+        }
+
+        queueForReduce(tc, toReduce);
+    }
+
+    // The pairs of a cancelled job that were not shuffled. The rest of the spilled pairs go with their files:
+    for (int j = 0; j < jc->_numOfWorkers; ++j)
+    {
+        deletePairs(next[j], last[j]);
+    }
+    for (SpillReader* reader : readers)
+    {
+        delete reader;
+    }
+    doneShuffling(jc);
+}
+
+/**
+ * The hash partitioned shuffle: groups the pairs of this worker's partition, out of every map result, in a hash
+ * table, and queues a vector for every key in it. All the workers group their partitions at the same time.
+ * @param tc A struct contains the inner data of a thread.
+ */
+static void groupPartition(ThreadContext* tc)
+{
+    JobContext *jc = tc->_job;
+    std::unordered_map<K2*, IntermediateVec, KeyHash, KeyEqual> groups;
+
+    try
+    {
+        for (ThreadContext* worker : jc->_contexts)
+        {
+            for (const IntermediatePair& pair : worker->_partitions[tc->_id])
+            {
+                groups[pair.first].push_back(pair);
+            }
+        }
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "system error: couldn't group the partition." << std::endl;
+        exit(1);
+    }
+
+    for (auto& group : groups)
+    {
+        if (isCancelled(jc))
+        {
+            deletePairs(group.second.begin(), group.second.end());
+        }
+        else
+        {
+            queueForReduce(tc, group.second);
+        }
+    }
+    doneShuffling(jc);
+}
+
+/**
+ * The reducing functionality: reduces groups from the queue until it is drained and closed.
+ * @param tc a struct contains the inner data of a thread.
+ */
+static void reduce(ThreadContext *tc)
+{
+    JobContext *jc = tc->_job;
+    IntermediateVec pairs;
+    HotKey* hotKey;
+    while (jc->_sync->queue.pop(pairs, hotKey))
+    {
+        if (hotKey)
+        {
+            reducePart(tc, pairs, hotKey);
+        }
+        else
+        {
+            reduceGroup(tc, pairs);
+        }
+    }
+}
+
+/**
+ * Pushes the pairs the thread emitted to the job's sink.
+ * @param tc: A struct contains the inner data of a thread.
+ */
+static void pushOutput(ThreadContext* tc)
+{
+    if (tc->_outputRes.empty())
+    {
+        return;
+    }
+    lock(&tc->_job->_sinkMutex);
+    tc->_job->_sink->consume(tc->_outputRes);
+    unlock(&tc->_job->_sinkMutex);
+    tc->_outputRes.clear();
+}
+
+/**
+ * Moves the pairs every thread emitted to the job's output vector, in one pass. Called by the last thread to finish
+ * reducing. In an ordered job every thread's pairs are already sorted, and they are merged.
+ * @param jc: the job's context.
+ */
+static void collectOutput(JobContext* jc)
+{
+    OutputVec* output = jc->_outputVec;
+    unsigned long total = output->size();
+    for (ThreadContext* tc : jc->_contexts)
+    {
+        total += tc->_outputRes.size();
+    }
+
+    std::vector<unsigned long> runs; // Where every thread's pairs start in the output.
+    try
+    {
+        output->reserve(total);
+        for (ThreadContext* tc : jc->_contexts)
+        {
+            runs.push_back(output->size());
+            output->insert(output->end(), tc->_outputRes.begin(), tc->_outputRes.end());
+            OutputVec().swap(tc->_outputRes);
+        }
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "system error: couldn't add to the output vector." << std::endl;
+        exit(1);
+    }
+    if (!jc->_config.orderedOutput)
+    {
+        return;
+    }
+
+    // Merges the sorted runs in pairs, until a single run is left:
+    runs.push_back(output->size());
+    while (runs.size() > 2)
+    {
+        std::vector<unsigned long> merged;
+        unsigned long i = 0;
+        for (; i + 2 < runs.size(); i += 2)
+        {
+            std::inplace_merge(output->begin() + runs[i], output->begin() + runs[i + 1],
+                               output->begin() + runs[i + 2], outputComparator);
+            merged.push_back(runs[i]);
+        }
+        if (i + 1 < runs.size())
+        {
+            merged.push_back(runs[i]); // An odd run out, merged in the next pass.
+        }
+        merged.push_back(runs.back());
+        runs.swap(merged);
+    }
+}
+
+/**
+ * Marks the job as done: wakes the threads waiting for it, and calls its completion callback if it has one.
+ * Called once, by the job's last worker (or when an empty job starts).
+ * @param jc: the job's context.
+ */
+static void finishJob(JobContext* jc)
+{
+    lock(&jc->_doneMutex);
+    jc->_finished = true;
+    jc->_endNs = nowNs();
+    // Copied under the lock: once it's released, a waiting thread may close the job.
+    JobCallback callback = jc->_callback;
+    void* arg = jc->_callbackArg;
+    if (pthread_cond_broadcast(&jc->_doneCond) != 0)
+    {
+        std::cerr << "system error: error on pthread_cond_broadcast." << std::endl;
+        exit(1);
+    }
+    unlock(&jc->_doneMutex);
+
+    if (callback)
+    {
+        callback(jc, arg);
+    }
+}
+
+/**
+ * @return true if the job is done. Taking _doneMutex also makes what the workers wrote to their contexts before
+ * the job was done visible to the caller.
+ */
+static bool isFinished(JobContext* jc)
+{
+    lock(&jc->_doneMutex);
+    bool finished = jc->_finished;
+    unlock(&jc->_doneMutex);
+    return finished;
+}
+
+/**
+ * This is the function that all of the threads of a job should run in order to preform the map reduce process.
+ * @param arg A struct contains the inner data of a thread.
+ * @return nullptr.
+ */
+static void* mapReduce(void *arg)
+{
+    auto *tc = (ThreadContext *) arg;
+    JobContext *jc = tc->_job;
+
+    // ------mapSort:
+    comparisons = 0;
+    beginPhase(tc, MAP_PHASE);
+    mapSort(tc);
+
+    // ------shuffle:
+    beginPhase(tc, SHUFFLE_PHASE);
+    if (tc->_id == splittingThread)
+    {
+        // Decided by a single thread, as the others must agree whether to read each other's map results:
+        jc->_skipShuffle = isCancelled(jc);
+        unsigned long total = 0;
+        for (ThreadContext* worker : jc->_contexts)
+        {
+            total += worker->_mapRes.size();
+            for (SpillRun* run : worker->_spills)
+            {
+                total += run->size();
+            }
+            for (const IntermediateVec& partition : worker->_partitions)
+            {
+                total += partition.size();
+            }
+        }
+        if (!jc->_config.hashPartition && !jc->_skipShuffle)
+        {
+            splitKeys(jc);
+        }
+        setStage(jc, REDUCE_STAGE, total);
+    }
+    beginPhase(tc, BARRIER_PHASE);
+    jc->_sync->barrier.barrier(tc->_id);
+    beginPhase(tc, SHUFFLE_PHASE);
+    if (jc->_skipShuffle)
+    {
+        dropMapResults(tc);
+        doneShuffling(jc);
+    }
+    else if (jc->_config.hashPartition)
+    {
+        groupPartition(tc);
+    }
+    else
+    {
+        shuffle(tc);
+    }
+
+    // ------reduce:
+    beginPhase(tc, REDUCE_PHASE);
+    reduce(tc);
+    beginPhase(tc, OUTPUT_PHASE);
+    if (jc->_sink)
+    {
+        if (isCancelled(jc))
+        {
+            dropOutput(tc->_outputRes);
+        }
+        pushOutput(tc);
+    }
+    else if (jc->_config.orderedOutput && !isCancelled(jc))
+    {
+        std::sort(tc->_outputRes.begin(), tc->_outputRes.end(), outputComparator);
+    }
+    endPhase(tc);
+    if (++(jc->_doneReducers) == jc->_numOfWorkers)
+    {
+        beginPhase(tc, OUTPUT_PHASE);
+        if (!jc->_sink && isCancelled(jc))
+        {
+            for (ThreadContext* worker : jc->_contexts)
+            {
+                dropOutput(worker->_outputRes);
+            }
+        }
+        else if (!jc->_sink)
+        {
+            collectOutput(jc);
+        }
+        endPhase(tc);
+        finishJob(jc);
+    }
+
+    return nullptr;
+}
+
+/**
+ * This function creates the job's workers and activates them, on the worker pool if the job has one, or on
+ * threads of their own.
+ * @param jc A struct contains the inner data of a job.
+ */
+static void initThreads(JobContext* jc) {
+
+    setStage(jc, MAP_STAGE, jc->_inputVec ? jc->_inputVec->size() : jc->_source->sizeHint());
+
+    //Initialize Threads contexts:
+    for (int i = 0; i < jc->_numOfWorkers; ++i) {
+        auto *tc = new ThreadContext(i, jc);
+        (jc->_contexts)[i] = tc;
+        if (jc->_config.hashPartition)
+        {
+            tc->_partitions.resize(jc->_numOfWorkers);
+        }
+        // Every thread starts with an equal share of the input vector:
+        if (jc->_inputVec && hasMapRanges(jc))
+        {
+            unsigned long size = jc->_inputVec->size();
+            tc->_mapRange.store(packRange(size * i / jc->_numOfWorkers, size * (i + 1) / jc->_numOfWorkers));
+        }
+    }
+
+    if (jc->_pool)
+    {
+        std::vector<void*> args(jc->_contexts.begin(), jc->_contexts.end());
+        jc->_gang = jc->_pool->submit(mapReduce, args);
+        return;
+    }
+
+    for (int i = 0; i < jc->_numOfWorkers; ++i) {
+        if (pthread_create(&jc->_contexts[i]->_thread, nullptr, mapReduce, jc->_contexts[i]))
+        {
+            std::cerr << "Error using pthread_create, on thread " << i << std::endl;
+            exit(1);
+        }
+    }
+}
+
+/**
+ * Creates a new job and starts it, with its input and output given as vectors or as a source and a sink.
+ * @return A job handler which is a pointer to the new job's context.
+ */
+static JobHandle startJob(const MapReduceClient &client, const InputVec* inputVec, OutputVec* outputVec,
+                          InputSource* source, OutputSink* sink, int multiThreadLevel, const JobConfig& config)
+{
+    assert(multiThreadLevel >= 0);
+
+    // A job on the pool can't have more workers than the pool has threads, as they all run at the same time:
+    lock(&poolMutex);
+    WorkerPool* pool = workerPool;
+    unlock(&poolMutex);
+    if (pool)
+    {
+        multiThreadLevel = std::min(multiThreadLevel, pool->size());
+    }
+
+    //Initialize The JobContext:
+    auto * jc = new JobContext(nextIndex++, &client, inputVec, outputVec, source, sink, multiThreadLevel, config,
+                               pool);
+
+    if(!isEmptyJob(jc)){
+        initThreads(jc);
+    }
+    else
+    {
+        finishJob(jc);
+    }
+
+    return jc;
+}
+
+//--------------------------------------------------PUBLIC METHODS--------------------------------------------------//
+
+/**
+ * This function produces a (K2*,V2*) pair.The context can be used to get pointers into the framework’s variables and
+ * data structures.
+ * @param key: The key of an intermediate element.
+ * @param value: The value of an intermediate element.
+ * @param context: The context of the calling thread.
+ */
+void emit2(K2 *key, V2 *value, void *context) {
+    // Converting context to the right type, unless the pair is for another runner:
+    auto *ec = static_cast<EmitContext *>(context);
+    if (ec->emitIntermediate)
+    {
+        ec->emitIntermediate(ec, key, value);
+        return;
+    }
+    auto *tc = static_cast<ThreadContext *>(ec);
+    ++tc->_emitted2;
+
+    // Inserting the map result to mapRes, or to its partition in a hash partitioned job, or the pair combined out
+    // of a hot key's part to the part's pairs:
+    try{
+        if (tc->_hotPairs)
+        {
+            tc->_hotPairs->push_back(IntermediatePair(key, value));
+        }
+        else if (tc->_job->_config.combine && !tc->_combining)
+        {
+            tc->_combineBuffer.push_back(IntermediatePair(key, value));
+            if (tc->_combineBuffer.size() >= tc->_job->_config.combineBuffer)
+            {
+                flushCombineBuffer(tc);
+            }
+        }
+        else if (tc->_partitions.empty())
+        {
+            tc->_mapRes.push_back(IntermediatePair(key, value));
+            unsigned long budget = tc->_job->_config.memoryBudget;
+            if (budget != 0 && tc->_mapRes.size() >= std::max(1UL, budget / tc->_job->_numOfWorkers))
+            {
+                spill(tc);
+            }
+        }
+        else
+        {
+            tc->_partitions[partitionOf(key, tc->_partitions.size())].push_back(IntermediatePair(key, value));
+        }
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "system error: couldn't add to the IntermediatePairs vector." << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * The default combine, used by clients that don't combine their pairs: emits the pairs unchanged.
+ * @param pairs: Pairs of the same key.
+ * @param context: The context of the calling thread.
+ */
+void MapReduceClient::combine(const IntermediateVec* pairs, void* context) const {
+    for (const IntermediatePair& pair : *pairs)
+    {
+        emit2(pair.first, pair.second, context);
+    }
+}
+
+/**
+ * The serialization hooks are needed only by jobs that spill to disk, so their defaults just report the missing
+ * implementation.
+ */
+static void missingSerializationHook(const char* hook)
+{
+    std::cerr << "MapReduceFramework error: a job with a memory budget spilled, but " << hook
+              << " is not implemented." << std::endl;
+    exit(1);
+}
+
+/**
+ * Hashing every key to the same value would make a hash partitioned job quadratic, so the default of the hash
+ * hook reports the missing implementation instead.
+ */
+size_t K2::hash() const {
+    std::cerr << "MapReduceFramework error: a job with hashPartition hashed a key, but K2::hash is not implemented."
+              << std::endl;
+    exit(1);
+}
+
+void K2::serialize(std::string& out) const {
+    (void) out;
+    missingSerializationHook("K2::serialize");
+}
+
+void V2::serialize(std::string& out) const {
+    (void) out;
+    missingSerializationHook("V2::serialize");
+}
+
+K2* MapReduceClient::deserializeKey(const char* data, size_t size) const {
+    (void) data;
+    (void) size;
+    missingSerializationHook("MapReduceClient::deserializeKey");
+    return nullptr;
+}
+
+V2* MapReduceClient::deserializeValue(const char* data, size_t size) const {
+    (void) data;
+    (void) size;
+    missingSerializationHook("MapReduceClient::deserializeValue");
+    return nullptr;
+}
+
+/**
+ * This function produces a (K3*,V3*) pair.The context can be used to get pointers into the framework’s variables and
+ * data structures.
+ * @param key: The key of an output element.
+ * @param value: The value of an output element.
+ * @param context: The context of the calling thread.
+ */
+void emit3(K3 *key, V3 *value, void *context) {
+    auto *ec = static_cast<EmitContext *>(context);
+    if (ec->emitOutput)
+    {
+        ec->emitOutput(ec, key, value);
+        return;
+    }
+    auto *tc = static_cast<ThreadContext *>(ec);
+    ++tc->_emitted3;
+
+    // Buffers the pair in the thread's own output, which is moved to the job's output when the job ends, or
+    // pushed to its sink whenever it fills:
+    try{
+        tc->_outputRes.push_back(OutputPair(key, value));
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "system error: couldn't to the output vector." << std::endl;
+        exit(1);
+    }
+    if (tc->_job->_sink && tc->_outputRes.size() >= OUTPUT_BATCH)
+    {
+        pushOutput(tc);
+    }
+}
+
+void waitForJob(JobHandle job) {
+    auto *jc = (JobContext *) job;
+
+    // If there are no elements to proceed the job is as good as done, and needs no waiting for.
+    // If we called wait once (hence the job is done: don't wait)
+    if(!isEmptyJob(jc) && !jc->_doneJob){
+        jc->_doneJob = true;
+        if (jc->_pool)
+        {
+            jc->_pool->wait(jc->_gang);
+            return;
+        }
+        for (int i = 0; i < jc->_numOfWorkers; ++i) {
+            if(pthread_join(jc->_contexts[i]->_thread, nullptr)){
+                std::cerr << "Error using pthread_join." << i << std::endl;
+                exit(1);
+            }
+        }
+    }
+}
+
+/**
+ * Waits until the job is done, or until a timeout passes. Unlike waitForJob, it doesn't join the job's threads,
+ * which closeJobHandle still does.
+ * @param job: A pointer to the job's context.
+ * @param timeoutMs: the longest time to wait, in milliseconds.
+ * @return true if the job is done, false on a timeout.
+ */
+bool waitForJobFor(JobHandle job, unsigned int timeoutMs) {
+    auto *jc = (JobContext *) job;
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += (long) (timeoutMs % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    lock(&jc->_doneMutex);
+    int res = 0;
+    while (!jc->_finished && res != ETIMEDOUT)
+    {
+        res = pthread_cond_timedwait(&jc->_doneCond, &jc->_doneMutex, &deadline);
+        if (res != 0 && res != ETIMEDOUT)
+        {
+            std::cerr << "system error: error on pthread_cond_timedwait." << std::endl;
+            exit(1);
+        }
+    }
+    bool finished = jc->_finished;
+    unlock(&jc->_doneMutex);
+    return finished;
+}
+
+/**
+ * Sets a function the job calls once when it's done, or calls it right away if the job is done already.
+ * @param job: A pointer to the job's context.
+ * @param callback: the function to call.
+ * @param arg: the argument to call it with.
+ */
+void setJobCompletionCallback(JobHandle job, JobCallback callback, void* arg) {
+    auto *jc = (JobContext *) job;
+    lock(&jc->_doneMutex);
+    bool finished = jc->_finished;
+    if (!finished)
+    {
+        jc->_callback = callback;
+        jc->_callbackArg = arg;
+    }
+    unlock(&jc->_doneMutex);
+
+    if (finished)
+    {
+        callback(jc, arg);
+    }
+}
+
+/**
+ * Cancels a job: its workers stop at the next unit of work (a chunk of input, a sort run or radix pass, a key),
+ * delete the intermediate pairs that were not reduced, and exit. The job is then done, with no output. Returns right
+ * away. Closing the job then takes about the time it takes the workers to delete the pairs, which is most of it.
+ * @param job: A pointer to the job's context.
+ */
+void cancelJob(JobHandle job) {
+    auto *jc = (JobContext *) job;
+    jc->_cancelled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * this function gets a job handle and check for his current state in a given JobState struct.
+ * @param job: A pointer to the job struct.
+ * @param state: A pointer to a state object to be filled with the current job's state.
+ */
+void getJobState(JobHandle job, JobState *state) {
+    auto *jc = (JobContext *) job;
+    if(!isEmptyJob(jc)){
+        unsigned long long progress = jc->_progress.load(std::memory_order_acquire);
+        auto stage = (stage_t) (progress >> STAGE_SHIFT);
+        unsigned long total = jc->_stageTotals[stage].load(std::memory_order_relaxed);
+
+        state->stage = stage;
+        if (total == 0)
+        {
+            // Nothing to process: a stage that didn't start yet is at 0%, any other stage is done. The map stage
+            // of a source of unknown size is at 0% until it's done.
+            state->percentage = (stage == UNDEFINED_STAGE || (stage == MAP_STAGE && jc->_source)) ? 0 : 100;
+        }
+        else
+        {
+            state->percentage = (float)((progress & PROCESSED_MASK) * (100.0 / total));
+        }
+    }
+
+    else {
+        // If there are no elements to proceed, the job is good as done:
+        state->percentage = 100;
+        state->stage = REDUCE_STAGE;
+    }
+
+}
+
+/**
+ * Fills a stats struct with the job's timings and counters, out of the ones every worker kept.
+ * @param job: A pointer to the job's context.
+ * @param stats: the struct to fill.
+ * @return false, leaving stats as it was, if the job is not done yet.
+ */
+bool getJobStats(JobHandle job, JobStats *stats) {
+    auto *jc = (JobContext *) job;
+    if (!isFinished(jc))
+    {
+        return false;
+    }
+    stats->totalMs = (jc->_endNs - jc->_startNs) / 1e6;
+    stats->emitted2 = stats->emitted3 = stats->groups = stats->comparisons = 0;
+    stats->workers.clear();
+
+    long long firstBegin[NUM_OF_PHASES], lastEnd[NUM_OF_PHASES];
+    for (int phase = 0; phase < NUM_OF_PHASES; ++phase)
+    {
+        firstBegin[phase] = -1;
+        lastEnd[phase] = -1;
+    }
+    for (ThreadContext* tc : jc->_contexts)
+    {
+        if (tc == nullptr) // An empty job has no workers.
+        {
+            continue;
+        }
+        WorkerStats worker = {{0}, tc->_emitted2, tc->_emitted3, tc->_groups, tc->_comparisons};
+        for (const PhaseSpan& span : tc->_spans)
+        {
+            worker.phaseMs[span._phase] += (span._end - span._begin) / 1e6;
+            if (firstBegin[span._phase] < 0 || span._begin < firstBegin[span._phase])
+            {
+                firstBegin[span._phase] = span._begin;
+            }
+            lastEnd[span._phase] = std::max(lastEnd[span._phase], span._end);
+        }
+        stats->emitted2 += worker.emitted2;
+        stats->emitted3 += worker.emitted3;
+        stats->groups += worker.groups;
+        stats->comparisons += worker.comparisons;
+        stats->workers.push_back(worker);
+    }
+    for (int phase = 0; phase < NUM_OF_PHASES; ++phase)
+    {
+        stats->phaseMs[phase] = (firstBegin[phase] < 0) ? 0 : (lastEnd[phase] - firstBegin[phase]) / 1e6;
+    }
+    return true;
+}
+
+/**
+ * Writes every worker's phases to a file, as complete ("X") events of the Chrome trace event format.
+ * @param job: A pointer to the job's context.
+ * @param path: the file to write.
+ * @return false if the job is not done yet, or if the file couldn't be written.
+ */
+bool dumpJobTrace(JobHandle job, const char *path) {
+    auto *jc = (JobContext *) job;
+    if (!isFinished(jc))
+    {
+        return false;
+    }
+    std::ofstream trace(path);
+    // The trace's times are in microseconds, written with their nanoseconds and never in exponent form:
+    trace << std::fixed << std::setprecision(3);
+    trace << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (ThreadContext* tc : jc->_contexts)
+    {
+        if (tc == nullptr)
+        {
+            continue;
+        }
+        for (const PhaseSpan& span : tc->_spans)
+        {
+            trace << (first ? "" : ",") << "\n  {\"name\": \"" << PHASE_NAMES[span._phase]
+                  << "\", \"ph\": \"X\", \"pid\": " << jc->_jid << ", \"tid\": " << tc->_id
+                  << ", \"ts\": " << span._begin / 1e3 << ", \"dur\": " << (span._end - span._begin) / 1e3 << "}";
+            first = false;
+        }
+    }
+    trace << "\n]}\n";
+    trace.close();
+    return !trace.fail();
+}
+
+/**
+ * Releasing all resources of a job, after the job was done. After using this function the jobHandle will be invalid.
+ * @param job: A pointer to the job's context.
+ */
+void closeJobHandle(JobHandle job) {
     auto *jc = (JobContext *) job;
     waitForJob(job);
 
@@ -525,6 +1920,33 @@ void closeJobHandle(JobHandle job) {
     delete(jc);
 }
 
+/**
+ * Starts the process wide worker pool. Jobs started from now on run their workers on the pool's threads instead of
+ * creating threads of their own. Does nothing if the pool is already running.
+ * @param numThreads: the number of threads in the pool, which is also the largest number of workers a job can have.
+ */
+void initWorkerPool(int numThreads) {
+    assert(numThreads > 0);
+    lock(&poolMutex);
+    if (workerPool == nullptr)
+    {
+        workerPool = new WorkerPool(numThreads);
+    }
+    unlock(&poolMutex);
+}
+
+/**
+ * Stops the process wide worker pool and joins its threads. Every job started on the pool must be closed first.
+ * Jobs started afterwards create threads of their own again.
+ */
+void shutdownWorkerPool() {
+    lock(&poolMutex);
+    WorkerPool* pool = workerPool;
+    workerPool = nullptr;
+    unlock(&poolMutex);
+    delete pool;
+}
+
 /**
  * his function creates a new job, and starts running the MapReduce algorithm for it.
  * @param client:  a map-reduce client.
@@ -536,31 +1958,38 @@ void closeJobHandle(JobHandle job) {
 JobHandle startMapReduceJob(const MapReduceClient &client,
                             const InputVec &inputVec, OutputVec &outputVec,
                             int multiThreadLevel) {
+    return startMapReduceJob(client, inputVec, outputVec, multiThreadLevel, JobConfig());
+}
 
-    assert(multiThreadLevel >= 0);
-
-    //Initialize The JobContext:
-    auto * jc = new JobContext((int)jobs.size(), &client, &inputVec, &outputVec, multiThreadLevel);
-
-    //Add the new job to the job's vector:
-    lock(&jobsMutex);
-    unsigned int currIndex = (nextIndex)++;
-
-    try{
-        jobs.insert({currIndex, jc});
-    }
-    catch (std::bad_alloc &e)
-    {
-        std::cerr << "system error: couldn't add the new job." << std::endl;
-        exit(1);
-    }
-    unlock(&jobsMutex);
-
-    if(!inputVec.empty()){
-        initThreads(jc);
-    }
+/**
+ * his function creates a new job, and starts running the MapReduce algorithm for it.
+ * @param client:  a map-reduce client.
+ * @param inputVec: A vector containing the input values.
+ * @param outputVec: A vector into which we insert the result of the map-reduce process.
+ * @param multiThreadLevel: The number of threads to participate in the map-reduce process.
+ * @param config: The job's tuning knobs.
+ * @return A job handler which is a pointer to the new job's context.
+ */
+JobHandle startMapReduceJob(const MapReduceClient &client,
+                            const InputVec &inputVec, OutputVec &outputVec,
+                            int multiThreadLevel, const JobConfig& config) {
+    return startJob(client, &inputVec, &outputVec, nullptr, nullptr, multiThreadLevel, config);
+}
 
-    return jc;
+/**
+ * This function creates a new job that streams its input and output, and starts running the MapReduce algorithm
+ * for it.
+ * @param client:  a map-reduce client.
+ * @param source: The source the job pulls its input pairs from.
+ * @param sink: The sink the job pushes its output pairs to.
+ * @param multiThreadLevel: The number of threads to participate in the map-reduce process.
+ * @param config: The job's tuning knobs.
+ * @return A job handler which is a pointer to the new job's context.
+ */
+JobHandle startMapReduceJob(const MapReduceClient &client,
+                            InputSource &source, OutputSink &sink,
+                            int multiThreadLevel, const JobConfig& config) {
+    return startJob(client, nullptr, nullptr, &source, &sink, multiThreadLevel, config);
 }
 
 
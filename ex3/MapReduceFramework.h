@@ -2,9 +2,14 @@
 #define MAPREDUCEFRAMEWORK_H
 
 #include "MapReduceClient.h"
+#include "Barrier.h"
+#include <vector>
 
 typedef void* JobHandle;
 
+// called once when a job is done (see setJobCompletionCallback), with the job and the argument it was set with.
+typedef void (*JobCallback)(JobHandle job, void* arg);
+
 enum stage_t {UNDEFINED_STAGE=0, MAP_STAGE=1, REDUCE_STAGE=2};
 
 typedef struct {
@@ -12,15 +17,210 @@ typedef struct {
     float percentage;
 } JobState;
 
+// the phases a job's workers go through, for getJobStats. BARRIER_PHASE is the waiting at the barriers between the
+// others, and OUTPUT_PHASE is the sorting, collecting or pushing of the output after the reduce.
+enum phase_t {MAP_PHASE=0, SORT_PHASE=1, BARRIER_PHASE=2, SHUFFLE_PHASE=3, REDUCE_PHASE=4, OUTPUT_PHASE=5};
+#define NUM_OF_PHASES 6
+
+/**
+ * What a single worker of a job did.
+ */
+struct WorkerStats {
+    double phaseMs[NUM_OF_PHASES];  // The time the worker spent in every phase.
+    unsigned long emitted2;         // The pairs emitted by emit2 on the worker (by map and by combine).
+    unsigned long emitted3;         // The pairs emitted by emit3 on the worker.
+    unsigned long groups;           // The groups of pairs with the same key the worker's shuffle queued.
+    unsigned long comparisons;      // The key comparisons of the worker's sorts of its map results.
+};
+
+/**
+ * What a job did, as a whole and by worker.
+ */
+struct JobStats {
+    double totalMs;                 // From the job's start until its output was complete.
+    double phaseMs[NUM_OF_PHASES];  // From the first worker starting the phase until the last one finishing it.
+    unsigned long emitted2;         // The sums of the workers' counters.
+    unsigned long emitted3;
+    unsigned long groups;
+    unsigned long comparisons;
+    std::vector<WorkerStats> workers;
+};
+
+/** The default maximal number of input pairs a worker claims at once. */
+#define DEFAULT_MAP_GRAIN 256
+
+/** The default number of intermediate pairs a worker buffers before combining them. */
+#define DEFAULT_COMBINE_BUFFER 4096
+
+/**
+ * Tuning knobs of a job. A default constructed config fits most jobs.
+ */
+struct JobConfig {
+    // The maximal number of input pairs a worker claims with a single atomic operation. The actual chunk shrinks
+    // as the input runs out, so the workers finish together.
+    unsigned int mapGrain;
+
+    // Groups the intermediate pairs by K2::hash instead of sorting them. Every key is still reduced exactly once
+    // with all of its values, but in no particular order. Fits jobs that only need their pairs grouped by key.
+    // The keys must implement K2::hash: the job exits on the first key that doesn't.
+    bool hashPartition;
+
+    // Runs MapReduceClient::combine on the pairs every worker emits, before they are shuffled: once on every
+    // combineBuffer pairs the worker emits, and once more on all of its pairs after they are sorted. Fits jobs that
+    // aggregate many values of a key into one.
+    bool combine;
+    unsigned int combineBuffer;
+
+    // The number of intermediate pairs the job keeps in memory, 0 for no limit. A worker whose pairs pass its share
+    // of the budget sorts them and spills them to a temporary file (in $TMPDIR, or /tmp), and the shuffle merges
+    // them back from there. The client must implement the serialization hooks of K2, V2 and MapReduceClient.
+    // Hash partitioned jobs keep all of their pairs in memory.
+    unsigned long memoryBudget;
+
+    // Sorts the pairs the job adds to the output vector by K3. Otherwise they are added in no particular order.
+    bool orderedOutput;
+
+    // The number of pairs above which a key's group is split, 0 to never split. The parts of a split group are
+    // combined (by MapReduceClient::combine) by several reducers at the same time, and the combined pairs are then
+    // reduced together, so a hot key doesn't leave a single reducer working alone. A group is split only among the
+    // reducers that are idle (waiting for a group) when it's queued, and queued whole if fewer than two are, as the
+    // extra combines then only add work. Fits jobs whose combine merges partial results, as a key is still reduced
+    // once. Requires combine to be set too, as a client that doesn't implement combine gains nothing from it: the
+    // default one emits the part's pairs as they are. Ignored otherwise.
+    unsigned long hotKeySplit;
+
+    // Sorts the intermediate pairs by K2::prefix with a radix sort, over the prefixes kept next to the pairs, and
+    // compares the keys themselves only when their prefixes are equal. The client's keys must implement prefix.
+    bool keyPrefix;
+
+    // The way the workers wait for each other between the stages (see Barrier.h). The dissemination barrier fits
+    // jobs with many workers.
+    barrier_t barrierKind;
+
+    JobConfig(): mapGrain(DEFAULT_MAP_GRAIN), hashPartition(false), combine(false),
+                 combineBuffer(DEFAULT_COMBINE_BUFFER), memoryBudget(0), orderedOutput(false), hotKeySplit(0),
+                 keyPrefix(false), barrierKind(FUTEX_BARRIER) {}
+};
+
+/**
+ * A source of input pairs that the job's workers pull batches from, so the input doesn't have to be in memory
+ * before the job starts. The framework makes one call to nextBatch or doneWith at a time, so a source needs no
+ * locking of its own for them.
+ */
+class InputSource {
+public:
+    virtual ~InputSource() {}
+
+    // adds up to maxPairs input pairs to the (empty) batch. returns false when the input is over.
+    virtual bool nextBatch(InputVec& batch, unsigned int maxPairs) = 0;
+
+    // called by the worker that pulled a batch, before it's mapped and with no lock held, so calls for different
+    // batches run at the same time. a source whose batch pairs stand for many inputs each (e.g. chunks of a file)
+    // adds those inputs to the (empty) inputs vector here, and returns true to have them mapped instead of the batch.
+    virtual bool expand(const InputVec& batch, InputVec& inputs) { (void) batch; (void) inputs; return false; }
+
+    // called after all the pairs of a batch (or all of its inputs) were mapped, so the source can release them.
+    virtual void doneWith(InputVec& batch) { (void) batch; }
+
+    // the number of input pairs, for getJobState. 0 if it isn't known, in which case the map stage is at 0% until
+    // it's done.
+    virtual unsigned long sizeHint() const { return 0; }
+};
+
+/**
+ * A destination of output pairs that the job's workers push batches to, as they reduce, so the output doesn't
+ * have to be held in memory. The framework makes one call at a time, so a sink needs no locking of its own.
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() {}
+
+    // takes a batch of output pairs, owning them from now on.
+    virtual void consume(const OutputVec& batch) = 0;
+};
+
+/**
+ * The context the client's functions get, and pass to emit2 and emit3. A runner other than the framework's workers
+ * (MapReduceClientJob, in MapReduceJob.h) sets the functions, to take the pairs emitted with it. The framework's
+ * workers leave them null.
+ */
+struct EmitContext {
+    void (*emitIntermediate)(EmitContext* context, K2* key, V2* value);
+    void (*emitOutput)(EmitContext* context, K3* key, V3* value);
+
+    EmitContext(): emitIntermediate(nullptr), emitOutput(nullptr) {}
+};
+
 void emit2 (K2* key, V2* value, void* context);
 void emit3 (K3* key, V3* value, void* context);
 
 JobHandle startMapReduceJob(const MapReduceClient& client,
                             const InputVec& inputVec, OutputVec& outputVec,
                             int multiThreadLevel);
+JobHandle startMapReduceJob(const MapReduceClient& client,
+                            const InputVec& inputVec, OutputVec& outputVec,
+                            int multiThreadLevel, const JobConfig& config);
+
+/**
+ * Starts a job that pulls its input from a source and pushes its output to a sink. JobConfig::orderedOutput doesn't
+ * apply to such a job, as its output is pushed while it's being reduced.
+ */
+JobHandle startMapReduceJob(const MapReduceClient& client,
+                            InputSource& source, OutputSink& sink,
+                            int multiThreadLevel, const JobConfig& config);
+
+/**
+ * Starts a process wide pool of threads that the workers of every job started afterwards run on, instead of
+ * creating and joining threads of their own. A job gets at most numThreads workers, and concurrent jobs are
+ * admitted in the order they were started. Does nothing if the pool is already running.
+ */
+void initWorkerPool(int numThreads);
+
+/**
+ * Stops the worker pool. Every job started on the pool must be closed before.
+ */
+void shutdownWorkerPool();
 
 void waitForJob(JobHandle job);
+
+/**
+ * Waits until the job is done, or until timeoutMs milliseconds have passed.
+ * @return true if the job is done (its output is complete), false on a timeout.
+ */
+bool waitForJobFor(JobHandle job, unsigned int timeoutMs);
+
+/**
+ * Sets a function to call once, when the job is done. It's called right away, on the calling thread, if the job is
+ * done already, and otherwise on the job's last worker, so it should be short, and must not wait for or close the
+ * job. A job has a single callback, which must be set at most once.
+ */
+void setJobCompletionCallback(JobHandle job, JobCallback callback, void* arg);
+
+/**
+ * Stops a job as soon as possible, without waiting for it. Its workers stop at the next chunk of input or key,
+ * delete the intermediate pairs they didn't reduce, and exit. A cancelled job adds nothing to its output vector,
+ * and pushes nothing more to its sink. The job still has to be closed, which waits for every worker to finish its
+ * unit of work (a map call on up to mapGrain pairs, a sort run, one merge of two sorted runs, a radix pass, or a
+ * key's reduce), and then to delete the pairs the job emitted so far. The deletes take most of that time, about as
+ * long as the client's reduce would take to delete the same pairs.
+ */
+void cancelJob(JobHandle job);
+
 void getJobState(JobHandle job, JobState* state);
+
+/**
+ * Fills stats with the job's timings and counters, which every worker keeps on its own as it runs.
+ * @return false, leaving stats as it was, if the job is not done yet (see waitForJobFor).
+ */
+bool getJobStats(JobHandle job, JobStats* stats);
+
+/**
+ * Writes the spans of every worker's phases to a file in the Chrome trace event format (for chrome://tracing or
+ * Perfetto), a row per worker.
+ * @return false if the job is not done yet, or if the file couldn't be written.
+ */
+bool dumpJobTrace(JobHandle job, const char* path);
+
 void closeJobHandle(JobHandle job);
 
 
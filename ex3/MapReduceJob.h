@@ -0,0 +1,446 @@
+#ifndef MAPREDUCEJOB_H
+#define MAPREDUCEJOB_H
+
+#include "MapReduceFramework.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <pthread.h>
+#include <utility>
+#include <vector>
+
+/**
+ * A statically typed map reduce job. Unlike the MapReduceClient API (see MapReduceFramework.h), keys and values are
+ * kept by value in contiguous vectors, and the client's functions and the keys' operator< are called directly, so
+ * the compiler can inline them into the sort and the merge.
+ *
+ * The client must provide:
+ *   template <typename Context> void map(const K1& key, const V1& value, Context& context) const;
+ *       calls context.emit(K2, V2) any number of times.
+ *   template <typename Context>
+ *   void reduce(const std::pair<K2, V2>* first, const std::pair<K2, V2>* last, Context& context) const;
+ *       gets all the pairs of a single key, and calls context.emit(K3, V3) any number of times (usually once).
+ * K2 must have operator<, and keys that are not less than each other are the same key.
+ *
+ * The output is ordered by K2: every worker reduces a range of keys, and the ranges are concatenated in order.
+ * The job runs on threads of its own, and has none of the framework's JobConfig options but mapGrain: no combine,
+ * spilling, hash partitioning, key prefixes, sinks or sources, and no JobHandle (state, stats, cancelling). The
+ * engine doesn't use the framework library. MapReduceClientJob, below, runs a MapReduceClient on it.
+ */
+template <typename K1, typename V1, typename K2, typename V2, typename K3, typename V3, typename Client>
+class MapReduceJob
+{
+public:
+    typedef std::pair<K1, V1> InputPair;
+    typedef std::pair<K2, V2> IntermediatePair;
+    typedef std::pair<K3, V3> OutputPair;
+    typedef std::vector<InputPair> InputVec;
+    typedef std::vector<IntermediatePair> IntermediateVec;
+    typedef std::vector<OutputPair> OutputVec;
+
+    /**
+     * The context of a map call.
+     */
+    class MapContext
+    {
+    public:
+        void emit(K2 key, V2 value)
+        {
+            _pairs->emplace_back(std::move(key), std::move(value));
+        }
+
+    private:
+        friend class MapReduceJob;
+        IntermediateVec* _pairs;
+    };
+
+    /**
+     * The context of a reduce call.
+     */
+    class ReduceContext
+    {
+    public:
+        void emit(K3 key, V3 value)
+        {
+            _pairs->emplace_back(std::move(key), std::move(value));
+        }
+
+    private:
+        friend class MapReduceJob;
+        OutputVec* _pairs;
+    };
+
+    /**
+     * Creates a job.
+     * @param client: the job's client.
+     * @param multiThreadLevel: the number of threads to run the job on, at least 1.
+     * @param mapGrain: the number of input pairs a thread claims at once.
+     */
+    MapReduceJob(const Client& client, int multiThreadLevel, unsigned int mapGrain = 256):
+            _client(client), _numOfWorkers(std::max(multiThreadLevel, 1)), _mapGrain(std::max(mapGrain, 1u)),
+            _input(nullptr), _next(0) {}
+
+    /**
+     * Runs the job to completion.
+     * @param input: the job's input.
+     * @param output: the vector the job's output is added to.
+     */
+    void run(const InputVec& input, OutputVec& output)
+    {
+        _input = &input;
+        _next = 0;
+        _workers.assign(_numOfWorkers, Worker());
+        if (pthread_barrier_init(&_barrier, nullptr, _numOfWorkers) != 0)
+        {
+            std::cerr << "System Error: An error had occurred while initializing Barrier." << std::endl;
+            exit(1);
+        }
+
+        for (int i = 0; i < _numOfWorkers; ++i)
+        {
+            _workers[i].job = this;
+            _workers[i].id = i;
+            if (pthread_create(&_workers[i].thread, nullptr, workerMain, &_workers[i]))
+            {
+                std::cerr << "Error using pthread_create, on thread " << i << std::endl;
+                exit(1);
+            }
+        }
+        for (int i = 0; i < _numOfWorkers; ++i)
+        {
+            if (pthread_join(_workers[i].thread, nullptr))
+            {
+                std::cerr << "Error using pthread_join." << i << std::endl;
+                exit(1);
+            }
+        }
+        pthread_barrier_destroy(&_barrier);
+
+        size_t total = output.size();
+        for (const Worker& worker : _workers)
+        {
+            total += worker.outputRes.size();
+        }
+        output.reserve(total);
+        for (Worker& worker : _workers)
+        {
+            std::move(worker.outputRes.begin(), worker.outputRes.end(), std::back_inserter(output));
+        }
+        _workers.clear();
+    }
+
+private:
+    /** the number of samples taken from every sorted run per worker, when choosing the workers' key ranges */
+    static const size_t SPLITTER_OVERSAMPLING = 16;
+
+    struct Worker
+    {
+        MapReduceJob* job;
+        int id;
+        pthread_t thread;
+        IntermediateVec mapRes;    // The results of the map stage, sorted.
+        std::vector<size_t> cuts;  // Worker i reduces mapRes[cuts[i], cuts[i + 1]) of every worker.
+        IntermediateVec shuffled;  // The worker's key range out of all the map results, sorted.
+        OutputVec outputRes;
+    };
+
+    static bool pairLess(const IntermediatePair& p1, const IntermediatePair& p2)
+    {
+        return p1.first < p2.first;
+    }
+
+    static void* workerMain(void* arg)
+    {
+        auto* worker = (Worker*) arg;
+        worker->job->work(*worker);
+        return nullptr;
+    }
+
+    void barrier()
+    {
+        int res = pthread_barrier_wait(&_barrier);
+        if (res != 0 && res != PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+            std::cerr << "[[Barrier]] error on pthread_barrier_wait" << std::endl;
+            exit(1);
+        }
+    }
+
+    /**
+     * The stages every worker runs: map and sort, split the keys (worker 0), merge the worker's key range and reduce.
+     */
+    void work(Worker& worker)
+    {
+        // ------map & sort:
+        MapContext mapContext;
+        mapContext._pairs = &worker.mapRes;
+        size_t size = _input->size();
+        for (size_t begin = _next.fetch_add(_mapGrain); begin < size; begin = _next.fetch_add(_mapGrain))
+        {
+            size_t end = std::min(begin + _mapGrain, size);
+            for (size_t i = begin; i < end; ++i)
+            {
+                _client.map((*_input)[i].first, (*_input)[i].second, mapContext);
+            }
+        }
+        std::sort(worker.mapRes.begin(), worker.mapRes.end(), pairLess);
+        barrier();
+
+        // ------shuffle:
+        if (worker.id == 0)
+        {
+            splitKeys();
+        }
+        barrier();
+
+        size_t groupSize = 0;
+        for (const Worker& other : _workers)
+        {
+            groupSize += other.cuts[worker.id + 1] - other.cuts[worker.id];
+        }
+        worker.shuffled.reserve(groupSize);
+        std::vector<size_t> runs;
+        for (Worker& other : _workers)
+        {
+            runs.push_back(worker.shuffled.size());
+            std::move(other.mapRes.begin() + other.cuts[worker.id], other.mapRes.begin() + other.cuts[worker.id + 1],
+                      std::back_inserter(worker.shuffled));
+        }
+        mergeRuns(worker.shuffled, runs);
+
+        // ------reduce:
+        ReduceContext reduceContext;
+        reduceContext._pairs = &worker.outputRes;
+        const IntermediatePair* pairs = worker.shuffled.data();
+        for (size_t begin = 0, end; begin < worker.shuffled.size(); begin = end)
+        {
+            end = begin + 1;
+            while (end < worker.shuffled.size() && !(pairs[begin].first < pairs[end].first))
+            {
+                ++end;
+            }
+            _client.reduce(pairs + begin, pairs + end, reduceContext);
+        }
+    }
+
+    /**
+     * Chooses one key range per worker out of samples of every sorted map result, and cuts the map results at the
+     * ranges' boundaries. Equal keys always fall in the same range.
+     */
+    void splitKeys()
+    {
+        size_t samplesPerRun = (size_t) _numOfWorkers * SPLITTER_OVERSAMPLING;
+        std::vector<K2> samples;
+        for (const Worker& worker : _workers)
+        {
+            size_t step = std::max((size_t) 1, worker.mapRes.size() / samplesPerRun);
+            for (size_t i = step / 2; i < worker.mapRes.size(); i += step)
+            {
+                samples.push_back(worker.mapRes[i].first);
+            }
+        }
+        std::sort(samples.begin(), samples.end());
+
+        std::vector<K2> splitters;
+        for (int i = 1; i < _numOfWorkers && !samples.empty(); ++i)
+        {
+            const K2& candidate = samples[i * samples.size() / _numOfWorkers];
+            if (splitters.empty() || splitters.back() < candidate)
+            {
+                splitters.push_back(candidate);
+            }
+        }
+
+        for (Worker& worker : _workers)
+        {
+            worker.cuts.assign(_numOfWorkers + 1, worker.mapRes.size());
+            worker.cuts[0] = 0;
+            for (size_t i = 0; i < splitters.size(); ++i)
+            {
+                worker.cuts[i + 1] = std::lower_bound(worker.mapRes.begin() + worker.cuts[i], worker.mapRes.end(),
+                                                      splitters[i],
+                                                      [](const IntermediatePair& pair, const K2& key)
+                                                      { return pair.first < key; }) - worker.mapRes.begin();
+            }
+        }
+    }
+
+    /**
+     * Merges consecutive sorted runs of a vector in pairs, until the whole vector is sorted.
+     * @param pairs: the runs.
+     * @param runs: where every run starts.
+     */
+    static void mergeRuns(IntermediateVec& pairs, std::vector<size_t>& runs)
+    {
+        runs.push_back(pairs.size());
+        while (runs.size() > 2)
+        {
+            std::vector<size_t> merged;
+            size_t i = 0;
+            for (; i + 2 < runs.size(); i += 2)
+            {
+                std::inplace_merge(pairs.begin() + runs[i], pairs.begin() + runs[i + 1], pairs.begin() + runs[i + 2],
+                                   pairLess);
+                merged.push_back(runs[i]);
+            }
+            if (i + 1 < runs.size())
+            {
+                merged.push_back(runs[i]); // An odd run out, merged in the next pass.
+            }
+            merged.push_back(runs.back());
+            runs.swap(merged);
+        }
+    }
+
+    const Client& _client;
+    int _numOfWorkers;
+    unsigned int _mapGrain;
+
+    const InputVec* _input;
+    std::atomic<size_t> _next; // The index of the next input pair to map.
+    pthread_barrier_t _barrier;
+    std::vector<Worker> _workers;
+};
+
+/**
+ * Runs a MapReduceClient on the statically typed engine of MapReduceJob, instead of the framework's workers. The
+ * pairs are kept as pointers, in the engine's vectors, and the client's emit2 and emit3 calls reach the engine
+ * through the context its functions get (see EmitContext). Only map and reduce are called, so the job has the
+ * engine's limits: its output is ordered by K2, and it takes no JobConfig but mapGrain.
+ */
+class MapReduceClientJob
+{
+public:
+    /**
+     * Creates a job.
+     * @param client: the job's client.
+     * @param multiThreadLevel: the number of threads to run the job on, at least 1.
+     * @param mapGrain: the number of input pairs a thread claims at once.
+     */
+    MapReduceClientJob(const MapReduceClient& client, int multiThreadLevel, unsigned int mapGrain = DEFAULT_MAP_GRAIN):
+            _runner(client), _numOfWorkers(multiThreadLevel), _mapGrain(mapGrain) {}
+
+    /**
+     * Runs the job to completion.
+     * @param input: the job's input.
+     * @param output: the vector the job's output is added to.
+     */
+    void run(const InputVec& input, OutputVec& output)
+    {
+        Engine(_runner, _numOfWorkers, _mapGrain).run(input, output);
+    }
+
+private:
+    /**
+     * An intermediate key, compared by the key it points to.
+     */
+    struct KeyRef
+    {
+        K2* key;
+
+        bool operator<(const KeyRef& other) const
+        {
+            return *key < *other.key;
+        }
+    };
+
+    /**
+     * The engine's client, calling the MapReduceClient with a context that emits to the engine's context.
+     */
+    class Runner
+    {
+    public:
+        explicit Runner(const MapReduceClient& client): _client(client) {}
+
+        template <typename Context>
+        void map(K1* const& key, V1* const& value, Context& context) const
+        {
+            MapEmitter<Context> emitter(context);
+            _client.map(key, value, static_cast<EmitContext*>(&emitter));
+        }
+
+        template <typename Context>
+        void reduce(const std::pair<KeyRef, V2*>* first, const std::pair<KeyRef, V2*>* last, Context& context) const
+        {
+            IntermediateVec pairs;
+            pairs.reserve(last - first);
+            for (const std::pair<KeyRef, V2*>* pair = first; pair != last; ++pair)
+            {
+                pairs.push_back(IntermediatePair(pair->first.key, pair->second));
+            }
+            ReduceEmitter<Context> emitter(context);
+            _client.reduce(&pairs, static_cast<EmitContext*>(&emitter));
+        }
+
+    private:
+        /**
+         * The context map gets, emitting to the engine's map context.
+         */
+        template <typename Context>
+        struct MapEmitter : public EmitContext
+        {
+            explicit MapEmitter(Context& context): context(context)
+            {
+                emitIntermediate = &MapEmitter::intermediate;
+                emitOutput = &misplacedEmit3;
+            }
+
+            static void intermediate(EmitContext* emitter, K2* key, V2* value)
+            {
+                static_cast<MapEmitter*>(emitter)->context.emit(KeyRef{key}, value);
+            }
+
+            Context& context;
+        };
+
+        /**
+         * The context reduce gets, emitting to the engine's reduce context.
+         */
+        template <typename Context>
+        struct ReduceEmitter : public EmitContext
+        {
+            explicit ReduceEmitter(Context& context): context(context)
+            {
+                emitIntermediate = &misplacedEmit2;
+                emitOutput = &ReduceEmitter::output;
+            }
+
+            static void output(EmitContext* emitter, K3* key, V3* value)
+            {
+                static_cast<ReduceEmitter*>(emitter)->context.emit(key, value);
+            }
+
+            Context& context;
+        };
+
+        static void misplacedEmit2(EmitContext* emitter, K2* key, V2* value)
+        {
+            (void) emitter;
+            (void) key;
+            (void) value;
+            std::cerr << "MapReduceFramework error: emit2 was called by reduce." << std::endl;
+            exit(1);
+        }
+
+        static void misplacedEmit3(EmitContext* emitter, K3* key, V3* value)
+        {
+            (void) emitter;
+            (void) key;
+            (void) value;
+            std::cerr << "MapReduceFramework error: emit3 was called by map." << std::endl;
+            exit(1);
+        }
+
+        const MapReduceClient& _client;
+    };
+
+    typedef MapReduceJob<K1*, V1*, KeyRef, V2*, K3*, V3*, Runner> Engine;
+
+    Runner _runner;
+    int _numOfWorkers;
+    unsigned int _mapGrain;
+};
+
+#endif //MAPREDUCEJOB_H
@@ -0,0 +1,124 @@
+#include "MappedTextSource.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** the size of a chunk, before it's extended to the end of its last line */
+static const size_t CHUNK_BYTES = 64 * 1024;
+
+MappedTextSource::MappedTextSource(const std::vector<std::string>& paths): _file(0), _offset(0)
+{
+    for (const std::string& path : paths)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) < 0)
+        {
+            std::cerr << "system error: couldn't open " << path << "." << std::endl;
+            exit(1);
+        }
+        if (info.st_size == 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // The mapping keeps the file.
+        if (data == MAP_FAILED)
+        {
+            std::cerr << "system error: couldn't map " << path << "." << std::endl;
+            exit(1);
+        }
+        // Only a hint, so a failure is harmless:
+        madvise(data, info.st_size, MADV_SEQUENTIAL);
+        _files.push_back({(const char*) data, (size_t) info.st_size});
+    }
+}
+
+MappedTextSource::~MappedTextSource()
+{
+    for (MappedFile& file : _files)
+    {
+        munmap((void*) file.data, file.size);
+    }
+    for (TextChunk* chunk : _freeChunks)
+    {
+        delete chunk;
+    }
+}
+
+bool MappedTextSource::nextBatch(InputVec& batch, unsigned int maxPairs)
+{
+    (void) maxPairs; // A batch is a chunk of lines, however many there are.
+    if (_file == _files.size())
+    {
+        return false;
+    }
+    const MappedFile& file = _files[_file];
+    const char* begin = file.data + _offset;
+    size_t size = std::min(CHUNK_BYTES, file.size - _offset);
+    // Extends the chunk to the end of the line it ends in, which is the only scanning done here:
+    auto end = (const char*) memchr(begin + size - 1, '\n', file.size - _offset - size + 1);
+    size = end ? (size_t) (end + 1 - begin) : file.size - _offset;
+
+    _offset += size;
+    if (_offset >= file.size)
+    {
+        ++_file;
+        _offset = 0;
+    }
+
+    TextChunk* chunk;
+    if (_freeChunks.empty())
+    {
+        chunk = new TextChunk();
+    }
+    else
+    {
+        chunk = _freeChunks.back();
+        _freeChunks.pop_back();
+    }
+    chunk->data = begin;
+    chunk->size = size;
+    batch.push_back(InputPair(nullptr, chunk));
+    return true;
+}
+
+bool MappedTextSource::expand(const InputVec& batch, InputVec& inputs)
+{
+    for (const InputPair& pair : batch)
+    {
+        auto chunk = static_cast<TextChunk*>(pair.second);
+        chunk->lines.clear();
+        for (size_t offset = 0; offset < chunk->size;)
+        {
+            const char* begin = chunk->data + offset;
+            auto end = (const char*) memchr(begin, '\n', chunk->size - offset);
+            size_t size = end ? (size_t) (end - begin) : chunk->size - offset;
+            chunk->lines.push_back({});
+            chunk->lines.back().data = begin;
+            chunk->lines.back().size = size;
+            offset += size + 1;
+        }
+        // Added once the chunk's vector won't grow again:
+        for (TextLine& line : chunk->lines)
+        {
+            inputs.push_back(InputPair(nullptr, &line));
+        }
+    }
+    return true;
+}
+
+void MappedTextSource::doneWith(InputVec& batch)
+{
+    for (InputPair& pair : batch)
+    {
+        _freeChunks.push_back(static_cast<TextChunk*>(pair.second));
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef MAPPEDTEXTSOURCE_H
+#define MAPPEDTEXTSOURCE_H
+
+#include "MapReduceFramework.h"
+#include <string>
+#include <vector>
+
+/**
+ * A line of a mapped text file, given to map as the input value (with a nullptr key). The line is not copied:
+ * data points into the file's mapping, and is valid only during the map call. The line's '\n' is not included.
+ */
+class TextLine : public V1 {
+public:
+    const char* data;
+    size_t size;
+};
+
+/**
+ * An input source that maps text files to memory and gives their lines to the job's workers, with no copying and
+ * no reading of the files before the job starts. The kernel reads the files ahead as the workers go through them.
+ * A batch is a single chunk of about CHUNK_BYTES of whole lines. Only finding the chunk's end is serialized: the
+ * worker that pulled it splits it into lines in expand.
+ */
+class MappedTextSource : public InputSource {
+public:
+    /**
+     * Maps the files. Empty files are skipped.
+     * @param paths: the files to read, in order.
+     */
+    explicit MappedTextSource(const std::vector<std::string>& paths);
+
+    /**
+     * Unmaps the files. Must not be called before the job using the source is done.
+     */
+    ~MappedTextSource();
+
+    bool nextBatch(InputVec& batch, unsigned int maxPairs);
+    bool expand(const InputVec& batch, InputVec& inputs);
+    void doneWith(InputVec& batch);
+
+private:
+    // A line aligned range of a file, and the lines it was split into.
+    class TextChunk : public V1 {
+    public:
+        const char* data;
+        size_t size;
+        std::vector<TextLine> lines;
+    };
+
+    struct MappedFile
+    {
+        const char* data;
+        size_t size;
+    };
+
+    std::vector<MappedFile> _files;
+    unsigned long _file;      // The file of the next line.
+    size_t _offset;           // The offset of the next chunk in its file.
+    std::vector<TextChunk*> _freeChunks; // Chunks that were mapped, reused (with their lines) by the next batches.
+};
+
+#endif //MAPPEDTEXTSOURCE_H
@@ -0,0 +1,169 @@
+#include "ReduceQueue.h"
+#include "Futex.h"
+#include <climits>
+
+//--------------Consts:
+/** the number of times a reducer retries an empty queue before it sleeps */
+static const int SPIN_TRIES = 128;
+
+ReduceQueue::ReduceQueue(unsigned long capacity): _mask(1), _enqueuePos(0), _dequeuePos(0), _signal(0),
+                                                   _sleepers(0), _waiting(0), _closed(false)
+{
+    while (_mask < capacity)
+    {
+        _mask <<= 1;
+    }
+    _cells = new Cell[_mask];
+    _mask -= 1;
+    reset();
+}
+
+ReduceQueue::~ReduceQueue()
+{
+    delete[] _cells;
+}
+
+void ReduceQueue::reset()
+{
+    for (unsigned long i = 0; i <= _mask; ++i)
+    {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _enqueuePos.store(0, std::memory_order_relaxed);
+    _dequeuePos.store(0, std::memory_order_relaxed);
+    _closed.store(false, std::memory_order_release);
+}
+
+bool ReduceQueue::tryPush(IntermediateVec& group, HotKey* hotKey)
+{
+    // A cell is free for the push at pos when its sequence is pos:
+    Cell* cell;
+    unsigned long pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &_cells[pos & _mask];
+        long diff = (long) cell->sequence.load(std::memory_order_acquire) - (long) pos;
+        if (diff == 0)
+        {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // The cell still holds the group of the previous lap.
+        }
+        else
+        {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->group = std::move(group);
+    cell->hotKey = hotKey;
+    group.clear();
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    wake(false);
+    return true;
+}
+
+bool ReduceQueue::tryPop(IntermediateVec& group, HotKey*& hotKey)
+{
+    // A cell holds the group for the pop at pos when its sequence is pos + 1:
+    Cell* cell;
+    unsigned long pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &_cells[pos & _mask];
+        long diff = (long) cell->sequence.load(std::memory_order_acquire) - (long) (pos + 1);
+        if (diff == 0)
+        {
+            if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = _dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    group = std::move(cell->group);
+    hotKey = cell->hotKey;
+    cell->group.clear();
+    cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+    return true;
+}
+
+bool ReduceQueue::pop(IntermediateVec& group, HotKey*& hotKey)
+{
+    if (tryPop(group, hotKey))
+    {
+        return true;
+    }
+    _waiting.fetch_add(1, std::memory_order_relaxed);
+    bool popped = waitPop(group, hotKey);
+    _waiting.fetch_sub(1, std::memory_order_relaxed);
+    return popped;
+}
+
+int ReduceQueue::idleReducers() const
+{
+    return _waiting.load(std::memory_order_relaxed);
+}
+
+bool ReduceQueue::waitPop(IntermediateVec& group, HotKey*& hotKey)
+{
+    while (true)
+    {
+        for (int i = 0; i < SPIN_TRIES; ++i)
+        {
+            if (tryPop(group, hotKey))
+            {
+                return true;
+            }
+            // Every push happens before the close, so a queue that is empty after the close stays empty:
+            if (_closed.load(std::memory_order_acquire))
+            {
+                return tryPop(group, hotKey);
+            }
+            cpuRelax();
+        }
+        park();
+    }
+}
+
+void ReduceQueue::park()
+{
+    int ticket = _signal.load(std::memory_order_acquire);
+    _sleepers.fetch_add(1, std::memory_order_seq_cst);
+
+    // Checks again after announcing the sleep: a pusher either sees the sleeper, or its group is seen here.
+    unsigned long pos = _dequeuePos.load(std::memory_order_seq_cst);
+    bool ready = _cells[pos & _mask].sequence.load(std::memory_order_seq_cst) == pos + 1;
+    if (!ready && !_closed.load(std::memory_order_seq_cst))
+    {
+        futexWait(&_signal, ticket);
+    }
+    _sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ReduceQueue::wake(bool all)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleepers.load(std::memory_order_relaxed) > 0)
+    {
+        _signal.fetch_add(1, std::memory_order_release);
+        futexWake(&_signal, all ? INT_MAX : 1);
+    }
+}
+
+void ReduceQueue::close()
+{
+    _closed.store(true, std::memory_order_seq_cst);
+    wake(true);
+}
@@ -0,0 +1,104 @@
+#ifndef REDUCEQUEUE_H
+#define REDUCEQUEUE_H
+
+#include "MapReduceClient.h"
+#include <atomic>
+
+/** The default number of groups a job's reduce queue holds. */
+#define DEFAULT_REDUCE_QUEUE 1024
+
+/** A key whose group was split into parts, reduced by several reducers (see MapReduceFramework.cpp). */
+struct HotKey;
+
+/**
+ * A bounded lock free queue of groups (vectors of pairs with the same key) between the shufflers, that push them,
+ * and the reducers, that pop them. Any thread may push and pop.
+ * A push never blocks: a shuffler that finds the queue full reduces the group itself. A reducer that finds the
+ * queue empty spins for a while, and then sleeps on a futex until a group is pushed or the queue is closed, so
+ * neither side makes a system call per group while the other keeps up.
+ */
+class ReduceQueue
+{
+public:
+    /**
+     * Creates an empty, open queue.
+     * @param capacity: The number of groups the queue holds, rounded up to a power of 2.
+     */
+    explicit ReduceQueue(unsigned long capacity);
+    ~ReduceQueue();
+
+    /**
+     * Prepares a drained queue for another job, opening it again.
+     */
+    void reset();
+
+    /**
+     * Moves a group into the queue, unless it's full.
+     * @param hotKey: the split key the group is a part of, nullptr for a whole group.
+     * @return true if the group was queued (and group was left empty), false if the queue is full.
+     */
+    bool tryPush(IntermediateVec& group, HotKey* hotKey = nullptr);
+
+    /**
+     * Moves the next group out of the queue, waiting for one if it's empty.
+     * @param hotKey: set to the split key the group is a part of, nullptr for a whole group.
+     * @return true if a group was moved into group, false if the queue is empty and closed.
+     */
+    bool pop(IntermediateVec& group, HotKey*& hotKey);
+
+    /**
+     * @return the number of reducers that found the queue empty and are waiting in pop for a group.
+     */
+    int idleReducers() const;
+
+    /**
+     * Marks the end of the stream: no group is pushed after it. Reducers drain the queue, and then pop returns false.
+     */
+    void close();
+
+private:
+    struct Cell
+    {
+        std::atomic<unsigned long> sequence; // Tells whether the cell is free or holds a group, for every lap.
+        IntermediateVec group;
+        HotKey* hotKey;
+    };
+
+    /**
+     * Moves the next group out of the queue if there's one.
+     */
+    bool tryPop(IntermediateVec& group, HotKey*& hotKey);
+
+    /**
+     * Waits for the next group: spins on the queue for a while, and then sleeps until a group is pushed.
+     */
+    bool waitPop(IntermediateVec& group, HotKey*& hotKey);
+
+    /**
+     * Sleeps until a group is pushed or the queue is closed, unless one of them happened already.
+     */
+    void park();
+
+    /**
+     * Wakes sleeping reducers, if there are any.
+     * @param all: wakes all of them when true, one of them otherwise.
+     */
+    void wake(bool all);
+
+    Cell* _cells;
+    unsigned long _mask;
+
+    // The producers' and the consumers' positions are written all the time, each in its own cache line:
+    char _pad0[64];
+    std::atomic<unsigned long> _enqueuePos;
+    char _pad1[64];
+    std::atomic<unsigned long> _dequeuePos;
+    char _pad2[64];
+
+    std::atomic<int> _signal;   // The futex word, changed by every wake.
+    std::atomic<int> _sleepers; // The number of reducers that are sleeping or going to sleep.
+    std::atomic<int> _waiting;  // The number of reducers in waitPop, spinning or sleeping.
+    std::atomic<bool> _closed;
+};
+
+#endif //REDUCEQUEUE_H
@@ -0,0 +1,221 @@
+#include "SpillRun.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+//--------------Consts:
+/** the number of bytes a run writes or reads at once */
+static const unsigned long WRITE_BUFFER = 1 << 20;
+static const unsigned long READ_BUFFER = 1 << 16;
+
+/** a run keeps the key of one record out of INDEX_STRIDE in memory */
+static const unsigned long INDEX_STRIDE = 1024;
+
+/** where the temporary files are created, unless $TMPDIR is set */
+static const char* DEFAULT_SPILL_DIR = "/tmp";
+
+/**
+ * Writes a whole buffer to a file.
+ */
+static void writeAll(int fd, const char* data, unsigned long size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            std::cerr << "system error: couldn't write a spilled run." << std::endl;
+            exit(1);
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+/**
+ * Appends a field's size to a record.
+ */
+static void appendSize(std::string& record, unsigned long size)
+{
+    auto fieldSize = (uint32_t) size;
+    record.append((const char*) &fieldSize, sizeof(fieldSize));
+}
+
+//------------------------------------------------- SpillRun -------------------------------------------------------//
+
+SpillRun::SpillRun(IntermediateVec& pairs): _fd(-1), _bytes(0), _size(pairs.size())
+{
+    const char* dir = getenv("TMPDIR");
+    std::string path = std::string(dir ? dir : DEFAULT_SPILL_DIR) + "/mapreduce-spill-XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    _fd = mkstemp(name.data());
+    if (_fd < 0)
+    {
+        std::cerr << "system error: couldn't create a file to spill to in " << (dir ? dir : DEFAULT_SPILL_DIR)
+                  << "." << std::endl;
+        exit(1);
+    }
+    unlink(name.data()); // The file lives as long as it's open.
+
+    std::string buffer, field;
+    buffer.reserve(WRITE_BUFFER);
+    for (unsigned long i = 0; i < pairs.size(); ++i)
+    {
+        IntermediatePair& pair = pairs[i];
+        bool indexed = (i % INDEX_STRIDE == 0);
+        if (indexed)
+        {
+            _index.push_back({pair.first, _bytes + (off_t) buffer.size()});
+        }
+
+        field.clear();
+        pair.first->serialize(field);
+        appendSize(buffer, field.size());
+        buffer += field;
+        field.clear();
+        pair.second->serialize(field);
+        appendSize(buffer, field.size());
+        buffer += field;
+
+        if (!indexed)
+        {
+            delete pair.first;
+        }
+        delete pair.second;
+
+        if (buffer.size() >= WRITE_BUFFER)
+        {
+            writeAll(_fd, buffer.data(), buffer.size());
+            _bytes += buffer.size();
+            buffer.clear();
+        }
+    }
+    writeAll(_fd, buffer.data(), buffer.size());
+    _bytes += buffer.size();
+    pairs.clear();
+}
+
+SpillRun::~SpillRun()
+{
+    close(_fd);
+    for (IndexEntry& entry : _index)
+    {
+        delete entry.key;
+    }
+}
+
+unsigned long SpillRun::size() const
+{
+    return _size;
+}
+
+const std::vector<SpillRun::IndexEntry>& SpillRun::index() const
+{
+    return _index;
+}
+
+//------------------------------------------------ SpillReader -----------------------------------------------------//
+
+SpillReader::SpillReader(const SpillRun& run, const MapReduceClient& client, const K2* low, const K2* high):
+        _run(run), _client(client), _high(high), _offset(0), _buffer(READ_BUFFER), _position(0), _end(0),
+        _key(nullptr)
+{
+    // Starts at the last indexed record before the range, and skips the records up to it:
+    for (const SpillRun::IndexEntry& entry : run._index)
+    {
+        if (low == nullptr || !(*entry.key < *low))
+        {
+            break;
+        }
+        _offset = entry.offset;
+    }
+    readKey();
+    while (low != nullptr && _key != nullptr && *_key < *low)
+    {
+        read(_field, readSize());
+        delete _key;
+        readKey();
+    }
+}
+
+SpillReader::~SpillReader()
+{
+    delete _key;
+}
+
+K2* SpillReader::key() const
+{
+    return _key;
+}
+
+IntermediatePair SpillReader::take()
+{
+    unsigned long size = readSize();
+    read(_field, size);
+    IntermediatePair pair(_key, _client.deserializeValue(_field.data(), size));
+    _key = nullptr;
+    readKey();
+    return pair;
+}
+
+void SpillReader::readKey()
+{
+    _key = nullptr;
+    if (_offset - (off_t) (_end - _position) >= _run._bytes)
+    {
+        return;
+    }
+    unsigned long size = readSize();
+    read(_field, size);
+    _key = _client.deserializeKey(_field.data(), size);
+    if (_high != nullptr && !(*_key < *_high))
+    {
+        delete _key;
+        _key = nullptr;
+    }
+}
+
+void SpillReader::read(std::string& out, unsigned long size)
+{
+    out.clear();
+    while (size > 0)
+    {
+        if (_position == _end)
+        {
+            ssize_t got = pread(_run._fd, _buffer.data(), _buffer.size(), _offset);
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (got <= 0)
+            {
+                std::cerr << "system error: couldn't read a spilled run." << std::endl;
+                exit(1);
+            }
+            _offset += got;
+            _position = 0;
+            _end = (unsigned long) got;
+        }
+        unsigned long chunk = std::min(size, _end - _position);
+        out.append(_buffer.data() + _position, chunk);
+        _position += chunk;
+        size -= chunk;
+    }
+}
+
+unsigned long SpillReader::readSize()
+{
+    uint32_t size;
+    read(_field, sizeof(size));
+    memcpy(&size, _field.data(), sizeof(size));
+    return size;
+}
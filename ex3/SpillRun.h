@@ -0,0 +1,109 @@
+#ifndef SPILLRUN_H
+#define SPILLRUN_H
+
+#include "MapReduceClient.h"
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * A sorted run of intermediate pairs, written to an anonymous temporary file when a worker's pairs pass the job's
+ * memory budget. The file is removed when the run is destroyed (or the process dies).
+ * A record is the key's size, the key, the value's size and the value, each written by its serialize hook.
+ * Every few records the run keeps the record's key in memory, with its offset, so a reader can start near a key
+ * without reading the whole file.
+ */
+class SpillRun
+{
+public:
+    struct IndexEntry
+    {
+        K2* key;
+        off_t offset;
+    };
+
+    /**
+     * Writes a sorted vector of pairs to a new temporary file, and deletes the pairs (but the indexed keys).
+     * @param pairs: the pairs to write, sorted. Left empty.
+     */
+    explicit SpillRun(IntermediateVec& pairs);
+
+    /**
+     * Closes (and so removes) the file, and deletes the indexed keys.
+     */
+    ~SpillRun();
+
+    /**
+     * @return the number of pairs in the run.
+     */
+    unsigned long size() const;
+
+    /**
+     * @return the keys kept in memory, in order, with the offsets of their records.
+     */
+    const std::vector<IndexEntry>& index() const;
+
+private:
+    friend class SpillReader;
+
+    int _fd;
+    off_t _bytes;
+    unsigned long _size;
+    std::vector<IndexEntry> _index;
+};
+
+/**
+ * Reads the pairs of a spilled run whose keys fall in a range, in order, with large sequential reads.
+ * Several readers may read the same run at the same time.
+ */
+class SpillReader
+{
+public:
+    /**
+     * Creates a reader positioned at the first pair of the range.
+     * @param run: the run to read.
+     * @param client: the client that deserializes the pairs.
+     * @param low: the first key of the range, nullptr for the beginning of the run.
+     * @param high: the key after the range, nullptr for the end of the run.
+     */
+    SpillReader(const SpillRun& run, const MapReduceClient& client, const K2* low, const K2* high);
+    ~SpillReader();
+
+    /**
+     * @return the key of the next pair, nullptr if the range is done.
+     */
+    K2* key() const;
+
+    /**
+     * @return the next pair, and moves past it. The caller owns the pair.
+     */
+    IntermediatePair take();
+
+private:
+    /**
+     * Reads the next record's key into _key, nullptr at the end of the run.
+     */
+    void readKey();
+
+    /**
+     * Copies the next size bytes of the run into out.
+     */
+    void read(std::string& out, unsigned long size);
+
+    /**
+     * @return the size of the next field of the record.
+     */
+    unsigned long readSize();
+
+    const SpillRun& _run;
+    const MapReduceClient& _client;
+    const K2* _high;
+    off_t _offset;             // The run's offset of the first byte past the buffer.
+    std::vector<char> _buffer;
+    unsigned long _position;   // The next byte to use in the buffer.
+    unsigned long _end;        // The number of valid bytes in the buffer.
+    K2* _key;                  // The key of the next pair, already read. The value isn't read yet.
+    std::string _field;
+};
+
+#endif //SPILLRUN_H
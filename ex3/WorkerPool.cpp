@@ -0,0 +1,256 @@
+#include "WorkerPool.h"
+#include <cstdlib>
+#include <iostream>
+
+//------------------------------------------------- JobSync --------------------------------------------------------//
+
+JobSync::JobSync(int numThreads, barrier_t barrierKind): barrier(numThreads, barrierKind), queue(DEFAULT_REDUCE_QUEUE)
+{
+}
+
+void JobSync::reset(int numThreads, barrier_t barrierKind)
+{
+    barrier.reset(numThreads, barrierKind);
+    queue.reset();
+}
+
+//------------------------------------------------ WorkerPool ------------------------------------------------------//
+
+struct WorkerPool::Gang
+{
+    Task task;
+    std::vector<void*> args;
+    int finished;  // The number of members that returned.
+};
+
+/**
+ * Locks the desired mutex.
+ * @param mutex: the mutex to lock
+ */
+static void lock(pthread_mutex_t *mutex)
+{
+    if (pthread_mutex_lock(mutex) != 0)
+    {
+        std::cerr << "error on pthread_mutex_lock" << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * Unlocks the desired mutex.
+ * @param mutex: the mutex to unlock
+ */
+static void unlock(pthread_mutex_t *mutex)
+{
+    if (pthread_mutex_unlock(mutex) != 0)
+    {
+        std::cerr << "error on pthread_mutex_unlock" << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * Waits on the desired condition variable.
+ */
+static void waitOn(pthread_cond_t *cv, pthread_mutex_t *mutex)
+{
+    if (pthread_cond_wait(cv, mutex) != 0)
+    {
+        std::cerr << "error on pthread_cond_wait" << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * Wakes every thread waiting on the desired condition variable.
+ */
+static void broadcast(pthread_cond_t *cv)
+{
+    if (pthread_cond_broadcast(cv) != 0)
+    {
+        std::cerr << "error on pthread_cond_broadcast" << std::endl;
+        exit(1);
+    }
+}
+
+WorkerPool::WorkerPool(int numThreads): _threads(numThreads), _idle(numThreads), _stopping(false)
+{
+    if (pthread_mutex_init(&_mutex, nullptr) != 0 || pthread_cond_init(&_workAvailable, nullptr) != 0 ||
+        pthread_cond_init(&_gangDone, nullptr) != 0)
+    {
+        std::cerr << "System Error: An error had occurred while initializing the worker pool." << std::endl;
+        exit(1);
+    }
+    for (int i = 0; i < numThreads; ++i)
+    {
+        if (pthread_create(&_threads[i], nullptr, workerMain, this))
+        {
+            std::cerr << "Error using pthread_create, on pool thread " << i << std::endl;
+            exit(1);
+        }
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    lock(&_mutex);
+    while (!_waiting.empty() || _idle < size())
+    {
+        waitOn(&_gangDone, &_mutex);
+    }
+    _stopping = true;
+    broadcast(&_workAvailable);
+    unlock(&_mutex);
+
+    for (pthread_t thread : _threads)
+    {
+        if (pthread_join(thread, nullptr))
+        {
+            std::cerr << "Error using pthread_join." << std::endl;
+            exit(1);
+        }
+    }
+    for (Gang* gang : _freeGangs)
+    {
+        delete gang;
+    }
+    for (JobSync* sync : _freeSyncs)
+    {
+        delete sync;
+    }
+    pthread_cond_destroy(&_gangDone);
+    pthread_cond_destroy(&_workAvailable);
+    pthread_mutex_destroy(&_mutex);
+}
+
+int WorkerPool::size() const
+{
+    return (int) _threads.size();
+}
+
+void* WorkerPool::workerMain(void* arg)
+{
+    ((WorkerPool*) arg)->workerLoop();
+    return nullptr;
+}
+
+void WorkerPool::workerLoop()
+{
+    lock(&_mutex);
+    while (true)
+    {
+        while (_ready.empty() && !_stopping)
+        {
+            waitOn(&_workAvailable, &_mutex);
+        }
+        if (_ready.empty())
+        {
+            break;
+        }
+        Gang* gang = _ready.front().first;
+        int member = _ready.front().second;
+        _ready.pop_front();
+        unlock(&_mutex);
+
+        gang->task(gang->args[member]);
+
+        lock(&_mutex);
+        ++_idle;
+        if (++(gang->finished) == (int) gang->args.size())
+        {
+            broadcast(&_gangDone);
+        }
+        admit();
+    }
+    unlock(&_mutex);
+}
+
+void WorkerPool::admit()
+{
+    bool admitted = false;
+    while (!_waiting.empty() && (int) _waiting.front()->args.size() <= _idle)
+    {
+        Gang* gang = _waiting.front();
+        _waiting.pop_front();
+        _idle -= (int) gang->args.size();
+        for (int i = 0; i < (int) gang->args.size(); ++i)
+        {
+            _ready.push_back(std::make_pair(gang, i));
+        }
+        admitted = true;
+    }
+    if (admitted)
+    {
+        broadcast(&_workAvailable);
+    }
+}
+
+WorkerPool::Gang* WorkerPool::submit(Task task, const std::vector<void*>& args)
+{
+    lock(&_mutex);
+    Gang* gang;
+    if (_freeGangs.empty())
+    {
+        gang = new Gang();
+    }
+    else
+    {
+        gang = _freeGangs.back();
+        _freeGangs.pop_back();
+    }
+    gang->task = task;
+    gang->args = args;
+    gang->finished = 0;
+
+    try
+    {
+        _waiting.push_back(gang);
+    }
+    catch (std::bad_alloc &e)
+    {
+        std::cerr << "system error: couldn't queue the job's workers." << std::endl;
+        exit(1);
+    }
+    admit();
+    unlock(&_mutex);
+    return gang;
+}
+
+void WorkerPool::wait(Gang* gang)
+{
+    lock(&_mutex);
+    while (gang->finished < (int) gang->args.size())
+    {
+        waitOn(&_gangDone, &_mutex);
+    }
+    unlock(&_mutex);
+}
+
+void WorkerPool::release(Gang* gang)
+{
+    lock(&_mutex);
+    _freeGangs.push_back(gang);
+    unlock(&_mutex);
+}
+
+JobSync* WorkerPool::acquireSync(int numThreads, barrier_t barrierKind)
+{
+    lock(&_mutex);
+    if (_freeSyncs.empty())
+    {
+        unlock(&_mutex);
+        return new JobSync(numThreads, barrierKind);
+    }
+    JobSync* sync = _freeSyncs.back();
+    _freeSyncs.pop_back();
+    unlock(&_mutex);
+    sync->reset(numThreads, barrierKind);
+    return sync;
+}
+
+void WorkerPool::releaseSync(JobSync* sync)
+{
+    lock(&_mutex);
+    _freeSyncs.push_back(sync);
+    unlock(&_mutex);
+}
@@ -0,0 +1,124 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include "Barrier.h"
+#include "ReduceQueue.h"
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+/**
+ * The synchronization objects shared by the workers of a single job. A pool keeps the ones of closed jobs, so a
+ * new job doesn't have to create its own.
+ */
+struct JobSync
+{
+    Barrier barrier;     // Separates the stages of the job.
+    ReduceQueue queue;   // The groups waiting to be reduced.
+
+    /**
+     * Creates the synchronization objects of a job.
+     * @param numThreads: The number of workers of the job.
+     * @param barrierKind: The kind of the job's barrier.
+     */
+    JobSync(int numThreads, barrier_t barrierKind);
+
+    /**
+     * Prepares the objects for a new job. Must not be called while a worker of the previous job uses them.
+     * @param numThreads: The number of workers of the new job.
+     * @param barrierKind: The kind of the new job's barrier.
+     */
+    void reset(int numThreads, barrier_t barrierKind);
+};
+
+/**
+ * A fixed set of threads that run the workers of many jobs, so a job doesn't pay for creating and joining threads
+ * of its own.
+ * The workers of a job wait for each other on barriers, so a job is admitted only when there are enough idle threads
+ * to run all of its workers at once (a "gang"). Gangs are admitted in the order they were submitted, so a big job
+ * is never starved by a stream of small ones.
+ */
+class WorkerPool
+{
+public:
+    typedef void* (*Task)(void*);
+
+    /** A submitted gang, waited for with wait() and given back with release(). */
+    struct Gang;
+
+    /**
+     * Starts the pool's threads.
+     * @param numThreads: The number of threads, at least 1.
+     */
+    explicit WorkerPool(int numThreads);
+
+    /**
+     * Waits until every submitted gang has finished, and joins the pool's threads.
+     */
+    ~WorkerPool();
+
+    /**
+     * @return The number of threads in the pool, which is the largest gang it can run.
+     */
+    int size() const;
+
+    /**
+     * Queues a gang that runs task(args[i]) for every i, each on its own thread and all at the same time.
+     * @param task: The function every member of the gang runs.
+     * @param args: The argument of every member. args.size() must not exceed size().
+     * @return The gang's handle.
+     */
+    Gang* submit(Task task, const std::vector<void*>& args);
+
+    /**
+     * Waits until every member of the gang has returned.
+     */
+    void wait(Gang* gang);
+
+    /**
+     * Gives a finished gang's handle back to the pool. The handle is invalid afterwards.
+     */
+    void release(Gang* gang);
+
+    /**
+     * @return Synchronization objects for a job with the given number of workers and kind of barrier, reused if the
+     * pool has any.
+     */
+    JobSync* acquireSync(int numThreads, barrier_t barrierKind);
+
+    /**
+     * Gives a closed job's synchronization objects back to the pool.
+     */
+    void releaseSync(JobSync* sync);
+
+private:
+    /**
+     * The entry point of the pool's threads.
+     */
+    static void* workerMain(void* arg);
+
+    /**
+     * Runs the members of admitted gangs until the pool is destroyed.
+     */
+    void workerLoop();
+
+    /**
+     * Admits waiting gangs, in order, while there are enough idle threads for the next one. Called with _mutex held.
+     */
+    void admit();
+
+    pthread_mutex_t _mutex;
+    pthread_cond_t _workAvailable;  // Signalled when members are admitted, or when the pool is destroyed.
+    pthread_cond_t _gangDone;       // Signalled when a gang's last member returns.
+
+    std::vector<pthread_t> _threads;
+    int _idle;                                 // Threads that are neither running a member nor reserved for one.
+    bool _stopping;
+    std::deque<Gang*> _waiting;                // Gangs that were not admitted yet.
+    std::deque<std::pair<Gang*, int>> _ready;  // Members of admitted gangs that no thread picked yet.
+
+    std::vector<Gang*> _freeGangs;
+    std::vector<JobSync*> _freeSyncs;
+};
+
+#endif //WORKERPOOL_H
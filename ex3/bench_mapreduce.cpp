@@ -0,0 +1,1385 @@
+#include "MapReduceFramework.h"
+#include "Barrier.h"
+#include "MapReduceJob.h"
+#include "MappedTextSource.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * MapReduceFramework benchmarks.
+ * Usage: bench_mapreduce [scenario ...]
+ * Runs the given scenarios (all of them by default) and prints the results to stdout as one JSON object, so they
+ * can be compared between builds.
+ */
+
+//--------------Consts:
+static const int THREAD_LEVELS[] = {1, 2, 4, 8, 16, 32, 64};
+static const int SCALING_INPUT = 1000000;
+static const int SCALING_KEYS = 1024;
+static const int SCALING_EMIT_EVERY = 64;  // The tiny map emits a pair for one input out of this many.
+static const int SMALL_JOBS = 2000;
+static const int SMALL_JOB_INPUT = 256;
+static const int SMALL_JOB_THREADS = 4;
+static const int WORD_COUNT_LINES = 100000;
+static const int WORDS_PER_LINE = 10;
+static const int VOCABULARY_SIZE = 50000;
+static const int SPILL_LINES = 400000;
+static const int SKEW_INPUT = 102400;
+static const int SKEW_HEAVY = 512;          // The first inputs of the skewed map cost SKEW_SPIN each.
+static const int SKEW_SPIN = 200000;
+static const int MAX_THREADS = 64;
+static const int ZIPF_INPUT = 200000;
+static const int ZIPF_SPIN = 1000;          // The cost of combining or reducing a value of the Zipf job.
+static const int ZIPF_HOT_KEY_SPLIT = 4096;
+static const int ZIPF_COMBINE_BUFFER = 1;    // Combines every pair alone, so the hot keys reach the shuffle whole.
+static const int BARRIER_THREADS[] = {2, 4, 8, 16, 32, 64, 128};
+static const int BARRIER_ROUNDS = 500;
+static const int COMPLETION_JOBS = 200;
+static const int COMPLETION_INPUT = 20480;
+static const int COMPLETION_IN_FLIGHT = 4;
+static const int SORT_PAIRS = 1000000;
+static const int SORT_LINES = SORT_PAIRS / WORDS_PER_LINE;
+static const long long NSEC_PER_SEC = 1000000000LL;
+
+//-------------Client Types:
+
+class IntInput : public V1 {
+public:
+    explicit IntInput(int value) : value(value) {}
+    int value;
+};
+
+class IntKey : public K2, public K3 {
+public:
+    explicit IntKey(int key) : key(key) {}
+
+    virtual bool operator<(const K2 &other) const {
+        return key < static_cast<const IntKey &>(other).key;
+    }
+
+    virtual bool operator<(const K3 &other) const {
+        return key < static_cast<const IntKey &>(other).key;
+    }
+
+    virtual size_t hash() const {
+        return (size_t) key;
+    }
+
+    virtual unsigned long long prefix() const {
+        return (unsigned long long) ((unsigned int) key ^ 0x80000000u) << 32;
+    }
+
+    int key;
+};
+
+class IntCount : public V2, public V3 {
+public:
+    explicit IntCount(int count) : count(count) {}
+
+    virtual void serialize(std::string &out) const {
+        out.append((const char *) &count, sizeof(count));
+    }
+    int count;
+};
+
+/**
+ * A client whose map is almost free, so the job's time is spent in the framework itself.
+ */
+class TinyMapClient : public MapReduceClient {
+public:
+    void map(const K1 *key, const V1 *value, void *context) const {
+        (void) key;
+        int v = static_cast<const IntInput *>(value)->value;
+        if (v % SCALING_EMIT_EVERY == 0) {
+            emit2(new IntKey(v % SCALING_KEYS), new IntCount(1), context);
+        }
+    }
+
+    void reduce(const IntermediateVec *pairs, void *context) const {
+        int count = 0;
+        for (const IntermediatePair &pair : *pairs) {
+            count += static_cast<const IntCount *>(pair.second)->count;
+            delete pair.first;
+            delete pair.second;
+        }
+        emit3(new IntKey(static_cast<const IntKey *>(pairs->at(0).first)->key), new IntCount(count), context);
+    }
+};
+
+/** the FinishTimes the running thread has a slot in, and the slot */
+static thread_local const void* finishOwner = nullptr;
+static thread_local int finishSlot = 0;
+
+/**
+ * The time every thread of a job last finished a call of the client, so the time the threads wait for each other
+ * at the end of a stage can be measured.
+ */
+class FinishTimes {
+public:
+    FinishTimes() : nextSlot(0) {}
+
+    void record() const {
+        if (finishOwner != this) {
+            finishOwner = this;
+            finishSlot = nextSlot++;
+        }
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        finished[finishSlot] = now.tv_sec * 1000000000LL + now.tv_nsec;
+    }
+
+    /**
+     * @return the average time in nanoseconds a thread finished before the last one did.
+     */
+    long long averageWaitNs() const {
+        int slots = nextSlot.load();
+        long long last = *std::max_element(finished, finished + slots);
+        long long total = 0;
+        for (int i = 0; i < slots; ++i) {
+            total += last - finished[i];
+        }
+        return total / std::max(1, slots);
+    }
+
+private:
+    mutable std::atomic<int> nextSlot;
+    mutable long long finished[MAX_THREADS];
+};
+
+static void spin(int iterations)
+{
+    volatile int sink = 0;
+    for (int i = 0; i < iterations; ++i) {
+        sink = sink + i;
+    }
+}
+
+/**
+ * TinyMapClient whose first SKEW_HEAVY inputs are far more expensive than the rest.
+ */
+class SkewedMapClient : public TinyMapClient {
+public:
+    void map(const K1 *key, const V1 *value, void *context) const {
+        if (static_cast<const IntInput *>(value)->value < SKEW_HEAVY) {
+            spin(SKEW_SPIN);
+        }
+        TinyMapClient::map(key, value, context);
+        mapFinish.record();
+    }
+
+    FinishTimes mapFinish;
+};
+
+class LineInput : public V1 {
+public:
+    explicit LineInput(const std::string& line) : line(line) {}
+    std::string line;
+};
+
+class WordKey : public K2, public K3 {
+public:
+    explicit WordKey(const std::string& word) : word(word) {}
+
+    virtual bool operator<(const K2 &other) const {
+        return word < static_cast<const WordKey &>(other).word;
+    }
+
+    virtual bool operator<(const K3 &other) const {
+        return word < static_cast<const WordKey &>(other).word;
+    }
+
+    virtual size_t hash() const {
+        return std::hash<std::string>()(word);
+    }
+
+    virtual unsigned long long prefix() const {
+        unsigned long long prefix = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            prefix = (prefix << 8) | (i < word.size() ? (unsigned char) word[i] : 0);
+        }
+        return prefix;
+    }
+
+    virtual void serialize(std::string &out) const {
+        out += word;
+    }
+
+    std::string word;
+};
+
+/**
+ * Counts the words of the input lines, so most of the job is spent grouping many distinct string keys.
+ */
+class WordCountClient : public MapReduceClient {
+public:
+    void map(const K1 *key, const V1 *value, void *context) const {
+        (void) key;
+        const std::string& line = static_cast<const LineInput *>(value)->line;
+        size_t begin = 0;
+        while (begin < line.size()) {
+            size_t end = line.find(' ', begin);
+            if (end == std::string::npos) {
+                end = line.size();
+            }
+            emit2(new WordKey(line.substr(begin, end - begin)), new IntCount(1), context);
+            begin = end + 1;
+        }
+    }
+
+    void reduce(const IntermediateVec *pairs, void *context) const {
+        int count = 0;
+        for (const IntermediatePair &pair : *pairs) {
+            count += static_cast<const IntCount *>(pair.second)->count;
+        }
+        emit3(new WordKey(static_cast<const WordKey *>(pairs->at(0).first)->word), new IntCount(count), context);
+        for (const IntermediatePair &pair : *pairs) {
+            delete pair.first;
+            delete pair.second;
+        }
+    }
+
+    K2 *deserializeKey(const char *data, size_t size) const {
+        return new WordKey(std::string(data, size));
+    }
+
+    V2 *deserializeValue(const char *data, size_t size) const {
+        int count;
+        memcpy(&count, data, std::min(size, sizeof(count)));
+        return new IntCount(count);
+    }
+};
+
+/**
+ * WordCountClient for lines of a MappedTextSource, splitting the words out of the mapped file.
+ */
+class MappedWordCountClient : public WordCountClient {
+public:
+    void map(const K1 *key, const V1 *value, void *context) const {
+        (void) key;
+        const TextLine *line = static_cast<const TextLine *>(value);
+        const char *end = line->data + line->size;
+        for (const char *begin = line->data; begin < end;) {
+            auto space = (const char *) memchr(begin, ' ', end - begin);
+            const char *wordEnd = space ? space : end;
+            emit2(new WordKey(std::string(begin, wordEnd)), new IntCount(1), context);
+            begin = wordEnd + 1;
+        }
+    }
+};
+
+/**
+ * Counts the input values by their remainder, emitting a pair for every input, so a combiner collapses almost
+ * all of them.
+ */
+class AggregateClient : public TinyMapClient {
+public:
+    void map(const K1 *key, const V1 *value, void *context) const {
+        (void) key;
+        emit2(new IntKey(static_cast<const IntInput *>(value)->value % SCALING_KEYS), new IntCount(1), context);
+    }
+
+    void combine(const IntermediateVec *pairs, void *context) const {
+        int count = 0;
+        for (const IntermediatePair &pair : *pairs) {
+            count += static_cast<const IntCount *>(pair.second)->count;
+            delete pair.second;
+        }
+        for (unsigned long i = 1; i < pairs->size(); ++i) {
+            delete pairs->at(i).first;
+        }
+        emit2(pairs->at(0).first, new IntCount(count), context);
+    }
+};
+
+/**
+ * Emits an output pair for every value it reduces, so the job's time is spent on emit3.
+ */
+class ReduceHeavyClient : public AggregateClient {
+public:
+    void reduce(const IntermediateVec *pairs, void *context) const {
+        int key = static_cast<const IntKey *>(pairs->at(0).first)->key;
+        for (const IntermediatePair &pair : *pairs) {
+            emit3(new IntKey(key), new IntCount(static_cast<const IntCount *>(pair.second)->count), context);
+            delete pair.first;
+            delete pair.second;
+        }
+    }
+};
+
+/**
+ * AggregateClient whose combine and reduce spend ZIPF_SPIN on every value, so the reduce stage takes time in
+ * proportion to the size of the groups.
+ */
+class ZipfClient : public AggregateClient {
+public:
+    void combine(const IntermediateVec *pairs, void *context) const {
+        spin(ZIPF_SPIN * (int) pairs->size());
+        AggregateClient::combine(pairs, context);
+        reduceFinish.record();
+    }
+
+    void reduce(const IntermediateVec *pairs, void *context) const {
+        spin(ZIPF_SPIN * (int) pairs->size());
+        AggregateClient::reduce(pairs, context);
+        reduceFinish.record();
+    }
+
+    FinishTimes reduceFinish;
+};
+
+/**
+ * The time a job's first reduce started, which is when the map results are sorted in a single threaded job.
+ */
+class FirstReduce {
+public:
+    FirstReduce() : startNs(0) {}
+
+    void record() const {
+        long long none = 0;
+        if (startNs.load(std::memory_order_relaxed) == 0) {
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            startNs.compare_exchange_strong(none, now.tv_sec * 1000000000LL + now.tv_nsec);
+        }
+    }
+
+    mutable std::atomic<long long> startNs;
+};
+
+/**
+ * Emits a pair for every input, with the input's value scattered over the int keys.
+ */
+class ScatteredKeyClient : public TinyMapClient {
+public:
+    void map(const K1 *key, const V1 *value, void *context) const {
+        (void) key;
+        unsigned int v = (unsigned int) static_cast<const IntInput *>(value)->value;
+        emit2(new IntKey((int) (v * 2654435761u)), new IntCount(1), context);
+    }
+
+    void reduce(const IntermediateVec *pairs, void *context) const {
+        firstReduce.record();
+        TinyMapClient::reduce(pairs, context);
+    }
+
+    FirstReduce firstReduce;
+};
+
+/**
+ * WordCountClient that keeps the time of its first reduce.
+ */
+class TimedWordCountClient : public WordCountClient {
+public:
+    void reduce(const IntermediateVec *pairs, void *context) const {
+        firstReduce.record();
+        WordCountClient::reduce(pairs, context);
+    }
+
+    FirstReduce firstReduce;
+};
+
+/**
+ * WordCountClient for the statically typed MapReduceJob, with the words and counts kept by value.
+ */
+class TypedWordCountClient {
+public:
+    template <typename Context>
+    void map(const int &key, const std::string &line, Context &context) const {
+        (void) key;
+        size_t begin = 0;
+        while (begin < line.size()) {
+            size_t end = line.find(' ', begin);
+            if (end == std::string::npos) {
+                end = line.size();
+            }
+            context.emit(line.substr(begin, end - begin), 1);
+            begin = end + 1;
+        }
+    }
+
+    template <typename Context>
+    void reduce(const std::pair<std::string, int> *first, const std::pair<std::string, int> *last,
+                Context &context) const {
+        int count = 0;
+        for (const std::pair<std::string, int> *pair = first; pair != last; ++pair) {
+            count += pair->second;
+        }
+        context.emit(first->first, count);
+    }
+};
+
+typedef MapReduceJob<int, std::string, std::string, int, std::string, int, TypedWordCountClient> TypedWordCountJob;
+
+//-------------Helpers:
+
+static std::vector<std::string> results;
+
+/**
+ * @return The current monotonic time in nanoseconds.
+ */
+static long long nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * Adds a benchmark result, given as the inner part of a JSON object, to the report.
+ */
+static void addResult(const std::string& name, const std::string& fields)
+{
+    results.push_back("{\"name\": \"" + name + "\", " + fields + "}");
+}
+
+static std::string field(const char* key, double value)
+{
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "\"%s\": %.3f", key, value);
+    return std::string(buffer);
+}
+
+static std::string field(const char* key, long long value)
+{
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "\"%s\": %lld", key, value);
+    return std::string(buffer);
+}
+
+static void makeIntInput(InputVec& input, int size)
+{
+    input.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        input.push_back(InputPair(nullptr, new IntInput(i)));
+    }
+}
+
+/**
+ * Makes lines of words drawn from a fixed vocabulary, with a fixed seed so every run counts the same words.
+ */
+static std::string makeLine(unsigned int* seed)
+{
+    std::string line;
+    for (int w = 0; w < WORDS_PER_LINE; ++w) {
+        if (w > 0) {
+            line += ' ';
+        }
+        line += "word" + std::to_string(rand_r(seed) % VOCABULARY_SIZE);
+    }
+    return line;
+}
+
+static void makeLineInput(InputVec& input, int lines)
+{
+    unsigned int seed = 1;
+    input.reserve(lines);
+    for (int i = 0; i < lines; ++i) {
+        input.push_back(InputPair(nullptr, new LineInput(makeLine(&seed))));
+    }
+}
+
+/**
+ * Makes the lines of makeLineInput as the workers pull them, and frees them once they are mapped.
+ */
+class LineSource : public InputSource {
+public:
+    explicit LineSource(int lines) : _left(lines), _seed(1) {}
+
+    bool nextBatch(InputVec &batch, unsigned int maxPairs) {
+        for (; _left > 0 && batch.size() < maxPairs; --_left) {
+            batch.push_back(InputPair(nullptr, new LineInput(makeLine(&_seed))));
+        }
+        return !batch.empty();
+    }
+
+    void doneWith(InputVec &batch) {
+        for (InputPair &pair : batch) {
+            delete pair.second;
+        }
+    }
+
+private:
+    int _left;
+    unsigned int _seed;
+};
+
+/**
+ * Sums the counts pushed to it, and frees the pairs.
+ */
+class CountingSink : public OutputSink {
+public:
+    CountingSink() : total(0), pairs(0) {}
+
+    void consume(const OutputVec &batch) {
+        for (const OutputPair &pair : batch) {
+            total += static_cast<const IntCount *>(pair.second)->count;
+            delete pair.first;
+            delete pair.second;
+        }
+        pairs += batch.size();
+    }
+
+    long long total;
+    long long pairs;
+};
+
+static void freeInput(InputVec& input)
+{
+    for (InputPair& pair : input) {
+        delete pair.second;
+    }
+    input.clear();
+}
+
+/**
+ * Verifies that the counts in the output sum up to expected, so a broken job doesn't produce a fast result.
+ */
+static void checkCounts(const OutputVec& output, long long expected, const char* scenario)
+{
+    long long total = 0;
+    for (const OutputPair& pair : output) {
+        total += static_cast<const IntCount *>(pair.second)->count;
+    }
+    if (total != expected) {
+        fprintf(stderr, "bench_mapreduce: %s produced %lld instead of %lld.\n", scenario, total, expected);
+        exit(1);
+    }
+}
+
+static void freeOutput(OutputVec& output)
+{
+    for (OutputPair& pair : output) {
+        delete pair.first;
+        delete pair.second;
+    }
+    output.clear();
+}
+
+/**
+ * Runs a job to completion.
+ * @return The job's wall time in nanoseconds.
+ */
+static long long timeJob(const MapReduceClient& client, const InputVec& input, OutputVec& output, int threads,
+                         const JobConfig& config)
+{
+    long long start = nowNs();
+    JobHandle job = startMapReduceJob(client, input, output, threads, config);
+    waitForJob(job);
+    long long elapsed = nowNs() - start;
+    closeJobHandle(job);
+    return elapsed;
+}
+
+//-------------Scenarios:
+
+/**
+ * Scaling of the map phase with a tiny map function, claiming the input one pair at a time and in chunks.
+ */
+static void benchMapScaling()
+{
+    TinyMapClient client;
+    InputVec input;
+    makeIntInput(input, SCALING_INPUT);
+
+    for (int threads : THREAD_LEVELS) {
+        for (unsigned int grain : {1u, (unsigned int) DEFAULT_MAP_GRAIN}) {
+            JobConfig config;
+            config.mapGrain = grain;
+            OutputVec output;
+            long long elapsed = timeJob(client, input, output, threads, config);
+            checkCounts(output, SCALING_INPUT / SCALING_EMIT_EVERY, "map_scaling");
+            freeOutput(output);
+            addResult("map_scaling",
+                      field("threads", (long long) threads) + ", " +
+                      field("map_grain", (long long) grain) + ", " +
+                      field("input_pairs", (long long) SCALING_INPUT) + ", " +
+                      field("ms", elapsed / 1e6));
+        }
+    }
+    freeInput(input);
+}
+
+struct PollerArgs {
+    JobHandle job;
+    volatile bool stop;
+    long long polls;
+};
+
+static void* pollJobState(void* arg)
+{
+    auto* args = (PollerArgs*) arg;
+    JobState state;
+    while (!args->stop) {
+        getJobState(args->job, &state);
+        args->polls++;
+    }
+    return nullptr;
+}
+
+/**
+ * The cost of a thread polling getJobState in a tight loop while the job runs.
+ */
+static void benchProgressPolling()
+{
+    TinyMapClient client;
+    InputVec input;
+    makeIntInput(input, SCALING_INPUT);
+    const int threads = 8;
+
+    for (bool polling : {false, true}) {
+        OutputVec output;
+        PollerArgs args = {nullptr, false, 0};
+        pthread_t poller;
+        long long start = nowNs();
+        args.job = startMapReduceJob(client, input, output, threads, JobConfig());
+        if (polling) {
+            pthread_create(&poller, nullptr, pollJobState, &args);
+        }
+        waitForJob(args.job);
+        long long elapsed = nowNs() - start;
+        if (polling) {
+            args.stop = true;
+            pthread_join(poller, nullptr);
+        }
+        closeJobHandle(args.job);
+        checkCounts(output, SCALING_INPUT / SCALING_EMIT_EVERY, "progress_polling");
+        freeOutput(output);
+        addResult("progress_polling",
+                  field("threads", (long long) threads) + ", " +
+                  field("polling", (long long) polling) + ", " +
+                  field("polls", args.polls) + ", " +
+                  field("ms", elapsed / 1e6));
+    }
+    freeInput(input);
+}
+
+/**
+ * An aggregation job, with and without combining the pairs before the shuffle.
+ */
+static void benchCombiner()
+{
+    AggregateClient client;
+    InputVec input;
+    makeIntInput(input, SCALING_INPUT);
+    const int threads = 8;
+
+    for (bool hashed : {false, true}) {
+        for (bool combine : {false, true}) {
+            JobConfig config;
+            config.hashPartition = hashed;
+            config.combine = combine;
+            OutputVec output;
+            long long elapsed = timeJob(client, input, output, threads, config);
+            checkCounts(output, SCALING_INPUT, "combiner");
+            freeOutput(output);
+            addResult("combiner",
+                      field("threads", (long long) threads) + ", " +
+                      field("hash_partition", (long long) hashed) + ", " +
+                      field("combine", (long long) combine) + ", " +
+                      field("input_pairs", (long long) SCALING_INPUT) + ", " +
+                      field("ms", elapsed / 1e6));
+        }
+    }
+    freeInput(input);
+}
+
+/**
+ * Scaling of a job whose reduces emit as many pairs as they get, with the output in any order and sorted.
+ */
+static void benchReduceHeavy()
+{
+    ReduceHeavyClient client;
+    InputVec input;
+    makeIntInput(input, SCALING_INPUT);
+
+    for (int threads : THREAD_LEVELS) {
+        for (bool ordered : {false, true}) {
+            JobConfig config;
+            config.orderedOutput = ordered;
+            OutputVec output;
+            long long elapsed = timeJob(client, input, output, threads, config);
+            checkCounts(output, SCALING_INPUT, "reduce_heavy");
+            for (unsigned long i = 1; ordered && i < output.size(); ++i) {
+                if (*(output[i].first) < *(output[i - 1].first)) {
+                    fprintf(stderr, "bench_mapreduce: reduce_heavy produced an unordered output.\n");
+                    exit(1);
+                }
+            }
+            freeOutput(output);
+            addResult("reduce_heavy",
+                      field("threads", (long long) threads) + ", " +
+                      field("ordered", (long long) ordered) + ", " +
+                      field("output_pairs", (long long) SCALING_INPUT) + ", " +
+                      field("ms", elapsed / 1e6));
+        }
+    }
+    freeInput(input);
+}
+
+/**
+ * The word count of benchWordCount, on the virtual MapReduceClient API, on the statically typed MapReduceJob, and
+ * with the virtual client run on the typed engine (MapReduceClientJob), which takes the engine's pair handling
+ * apart from the virtual calls.
+ */
+static void benchTypedWordCount()
+{
+    WordCountClient client;
+    InputVec input;
+    makeLineInput(input, WORD_COUNT_LINES);
+    TypedWordCountClient typedClient;
+    TypedWordCountJob::InputVec typedInput;
+    for (const InputPair &pair : input) {
+        typedInput.push_back(TypedWordCountJob::InputPair(0, static_cast<const LineInput *>(pair.second)->line));
+    }
+
+    for (int threads : {1, 4, 8}) {
+        OutputVec output;
+        long long virtualNs = timeJob(client, input, output, threads, JobConfig());
+        checkCounts(output, (long long) WORD_COUNT_LINES * WORDS_PER_LINE, "typed_word_count");
+        freeOutput(output);
+
+        long long start = nowNs();
+        MapReduceClientJob(client, threads).run(input, output);
+        long long clientOnEngineNs = nowNs() - start;
+        checkCounts(output, (long long) WORD_COUNT_LINES * WORDS_PER_LINE, "typed_word_count");
+        freeOutput(output);
+
+        TypedWordCountJob::OutputVec typedOutput;
+        start = nowNs();
+        TypedWordCountJob(typedClient, threads).run(typedInput, typedOutput);
+        long long typedNs = nowNs() - start;
+        long long total = 0;
+        for (const TypedWordCountJob::OutputPair &pair : typedOutput) {
+            total += pair.second;
+        }
+        if (total != (long long) WORD_COUNT_LINES * WORDS_PER_LINE) {
+            fprintf(stderr, "bench_mapreduce: typed_word_count produced %lld words.\n", total);
+            exit(1);
+        }
+
+        addResult("typed_word_count",
+                  field("threads", (long long) threads) + ", " +
+                  field("input_lines", (long long) WORD_COUNT_LINES) + ", " +
+                  field("virtual_ms", virtualNs / 1e6) + ", " +
+                  field("virtual_on_engine_ms", clientOnEngineNs / 1e6) + ", " +
+                  field("typed_ms", typedNs / 1e6) + ", " +
+                  field("speedup", (double) virtualNs / typedNs));
+    }
+    freeInput(input);
+}
+
+/**
+ * A word count with no memory budget and with a budget far below its intermediate pairs, which makes it spill to
+ * disk. Every job runs in a child process, so its peak RSS is measured alone.
+ */
+static void benchSpill()
+{
+    const int threads = 4;
+    const long long words = (long long) SPILL_LINES * WORDS_PER_LINE;
+
+    for (unsigned long budget : {0UL, (unsigned long) (words / 16)}) {
+        fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            WordCountClient client;
+            InputVec input;
+            makeLineInput(input, SPILL_LINES);
+            JobConfig config;
+            config.memoryBudget = budget;
+            OutputVec output;
+            timeJob(client, input, output, threads, config);
+            checkCounts(output, words, "spill");
+            _exit(0);
+        }
+        int status;
+        rusage usage;
+        long long start = nowNs();
+        if (child < 0 || wait4(child, &status, 0, &usage) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "bench_mapreduce: the spill job failed.\n");
+            exit(1);
+        }
+        long long elapsed = nowNs() - start;
+        addResult("spill",
+                  field("threads", (long long) threads) + ", " +
+                  field("memory_budget_pairs", (long long) budget) + ", " +
+                  field("intermediate_pairs", words) + ", " +
+                  field("peak_rss_kb", (long long) usage.ru_maxrss) + ", " +
+                  field("ms_with_input", elapsed / 1e6));
+    }
+}
+
+/**
+ * A word count over an input that is made up front into a vector, and the same one made as it is pulled from a
+ * source and pushed to a sink. Both include making the input, and the streaming job never holds all of it.
+ */
+static void benchStreaming()
+{
+    WordCountClient client;
+    const int threads = 4;
+    const long long words = (long long) WORD_COUNT_LINES * WORDS_PER_LINE;
+
+    long long start = nowNs();
+    InputVec input;
+    makeLineInput(input, WORD_COUNT_LINES);
+    OutputVec output;
+    timeJob(client, input, output, threads, JobConfig());
+    long long vectorNs = nowNs() - start;
+    checkCounts(output, words, "streaming");
+    freeOutput(output);
+    freeInput(input);
+
+    start = nowNs();
+    LineSource source(WORD_COUNT_LINES);
+    CountingSink sink;
+    JobHandle job = startMapReduceJob(client, source, sink, threads, JobConfig());
+    closeJobHandle(job);
+    long long streamNs = nowNs() - start;
+    if (sink.total != words) {
+        fprintf(stderr, "bench_mapreduce: streaming produced %lld instead of %lld.\n", sink.total, words);
+        exit(1);
+    }
+
+    addResult("streaming",
+              field("threads", (long long) threads) + ", " +
+              field("input_lines", (long long) WORD_COUNT_LINES) + ", " +
+              field("vector_ms", vectorNs / 1e6) + ", " +
+              field("stream_ms", streamNs / 1e6));
+}
+
+/**
+ * A word count over a text file, read line by line into a vector up front, and mapped by a MappedTextSource.
+ * load_ms is the time until the job can start, ms the whole time including it.
+ */
+static void benchMappedText()
+{
+    const int threads = 4;
+    const long long words = (long long) WORD_COUNT_LINES * WORDS_PER_LINE;
+    const char* dir = getenv("TMPDIR");
+    std::string path = std::string(dir ? dir : "/tmp") + "/bench_mapreduce-" + std::to_string(getpid()) + ".txt";
+    {
+        std::ofstream file(path);
+        unsigned int seed = 1;
+        for (int i = 0; i < WORD_COUNT_LINES; ++i) {
+            file << makeLine(&seed) << '\n';
+        }
+        if (!file) {
+            fprintf(stderr, "bench_mapreduce: couldn't write %s.\n", path.c_str());
+            exit(1);
+        }
+    }
+
+    for (bool mapped : {false, true}) {
+        long long start = nowNs();
+        long long loadNs;
+        if (mapped) {
+            MappedWordCountClient client;
+            MappedTextSource source({path});
+            loadNs = nowNs() - start;
+            CountingSink sink;
+            JobHandle job = startMapReduceJob(client, source, sink, threads, JobConfig());
+            closeJobHandle(job);
+            if (sink.total != words) {
+                fprintf(stderr, "bench_mapreduce: mapped_text produced %lld instead of %lld.\n", sink.total, words);
+                exit(1);
+            }
+        } else {
+            WordCountClient client;
+            InputVec input;
+            std::ifstream file(path);
+            std::string line;
+            while (std::getline(file, line)) {
+                input.push_back(InputPair(nullptr, new LineInput(line)));
+            }
+            loadNs = nowNs() - start;
+            OutputVec output;
+            timeJob(client, input, output, threads, JobConfig());
+            checkCounts(output, words, "mapped_text");
+            freeOutput(output);
+            freeInput(input);
+        }
+        long long elapsed = nowNs() - start;
+        addResult("mapped_text",
+                  field("threads", (long long) threads) + ", " +
+                  field("mapped", (long long) mapped) + ", " +
+                  field("input_lines", (long long) WORD_COUNT_LINES) + ", " +
+                  field("load_ms", loadNs / 1e6) + ", " +
+                  field("ms", elapsed / 1e6));
+    }
+    unlink(path.c_str());
+}
+
+/**
+ * A map whose expensive inputs are all at the start of the input vector. barrier_wait_ms is the average time a thread
+ * finished mapping before the last one, which it spends waiting at the barrier.
+ */
+static void benchSkewedMap()
+{
+    InputVec input;
+    makeIntInput(input, SKEW_INPUT);
+
+    for (int threads : {2, 4, 8}) {
+        SkewedMapClient client;
+        OutputVec output;
+        long long elapsed = timeJob(client, input, output, threads, JobConfig());
+        checkCounts(output, SKEW_INPUT / SCALING_EMIT_EVERY, "skewed_map");
+        freeOutput(output);
+        addResult("skewed_map",
+                  field("threads", (long long) threads) + ", " +
+                  field("input_pairs", (long long) SKEW_INPUT) + ", " +
+                  field("heavy_pairs", (long long) SKEW_HEAVY) + ", " +
+                  field("barrier_wait_ms", client.mapFinish.averageWaitNs() / 1e6) + ", " +
+                  field("ms", elapsed / 1e6));
+    }
+    freeInput(input);
+}
+
+/**
+ * Makes an input of keys drawn from a Zipf distribution over SCALING_KEYS keys, so a few keys are most of it.
+ */
+static void makeZipfInput(InputVec& input, int size)
+{
+    std::vector<double> cumulative(SCALING_KEYS);
+    double total = 0;
+    for (int rank = 0; rank < SCALING_KEYS; ++rank) {
+        total += 1.0 / (rank + 1);
+        cumulative[rank] = total;
+    }
+    unsigned int seed = 1;
+    input.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        double point = total * rand_r(&seed) / RAND_MAX;
+        int key = (int) (std::lower_bound(cumulative.begin(), cumulative.end(), point) - cumulative.begin());
+        input.push_back(InputPair(nullptr, new IntInput(std::min(key, SCALING_KEYS - 1))));
+    }
+}
+
+/**
+ * An aggregation whose keys are Zipf distributed, with its hot keys' groups reduced whole and split. The pairs are
+ * hash partitioned and combined one by one, so the map side doesn't shrink the hot keys' groups before the shuffle.
+ * reduce_wait_ms is the average time a thread finished reducing before the last one, and total_ms the time of the
+ * whole job, which is what a split must improve.
+ */
+static void benchHotKeys()
+{
+    InputVec input;
+    makeZipfInput(input, ZIPF_INPUT);
+    const int threads = 4;
+
+    for (unsigned long split : {0UL, (unsigned long) ZIPF_HOT_KEY_SPLIT}) {
+        ZipfClient client;
+        JobConfig config;
+        config.combine = true; // Splitting requires it.
+        config.combineBuffer = ZIPF_COMBINE_BUFFER;
+        config.hashPartition = true;
+        config.hotKeySplit = split;
+        OutputVec output;
+        long long elapsed = timeJob(client, input, output, threads, config);
+        checkCounts(output, ZIPF_INPUT, "hot_keys");
+        if (output.size() > (unsigned long) SCALING_KEYS) {
+            fprintf(stderr, "bench_mapreduce: hot_keys reduced a key more than once.\n");
+            exit(1);
+        }
+        freeOutput(output);
+        addResult("hot_keys",
+                  field("threads", (long long) threads) + ", " +
+                  field("hot_key_split", (long long) split) + ", " +
+                  field("input_pairs", (long long) ZIPF_INPUT) + ", " +
+                  field("reduce_wait_ms", client.reduceFinish.averageWaitNs() / 1e6) + ", " +
+                  field("total_ms", elapsed / 1e6));
+    }
+    freeInput(input);
+}
+
+/**
+ * Map and sort on a single thread, with the pairs sorted by comparing the keys and by radix on their prefixes, for
+ * scattered int keys and for words. The time until the first reduce covers the map, which is the same either way,
+ * and the sort, and is given per million pairs.
+ */
+static void benchKeySort()
+{
+    for (bool words : {false, true}) {
+        InputVec input;
+        if (words) {
+            makeLineInput(input, SORT_LINES);
+        } else {
+            makeIntInput(input, SORT_PAIRS);
+        }
+        for (bool prefixed : {false, true}) {
+            ScatteredKeyClient intClient;
+            TimedWordCountClient wordClient;
+            const MapReduceClient& client = words ? (const MapReduceClient&) wordClient : intClient;
+            const FirstReduce& firstReduce = words ? wordClient.firstReduce : intClient.firstReduce;
+            JobConfig config;
+            config.keyPrefix = prefixed;
+            OutputVec output;
+            long long start = nowNs();
+            long long elapsed = timeJob(client, input, output, 1, config);
+            checkCounts(output, SORT_PAIRS, "key_sort");
+            freeOutput(output);
+            addResult("key_sort",
+                      field("word_keys", (long long) words) + ", " +
+                      field("key_prefix", (long long) prefixed) + ", " +
+                      field("intermediate_pairs", (long long) SORT_PAIRS) + ", " +
+                      field("map_sort_ms_per_million",
+                            (firstReduce.startNs - start) / 1e6 * 1000000 / SORT_PAIRS) + ", " +
+                      field("ms", elapsed / 1e6));
+        }
+        freeInput(input);
+    }
+}
+
+struct BarrierArgs {
+    Barrier* barrier;
+    int id;
+};
+
+static void* passBarrier(void* arg)
+{
+    auto* args = (BarrierArgs*) arg;
+    for (int i = 0; i < BARRIER_ROUNDS; ++i) {
+        args->barrier->barrier(args->id);
+    }
+    return nullptr;
+}
+
+/**
+ * The time it takes a group of threads to pass a barrier, for every kind of barrier, averaged over BARRIER_ROUNDS
+ * barriers in a row.
+ */
+static void benchBarrier()
+{
+    const char* names[] = {"condition", "futex", "dissemination"};
+    for (int threads : BARRIER_THREADS) {
+        for (barrier_t kind : {CONDITION_BARRIER, FUTEX_BARRIER, DISSEMINATION_BARRIER}) {
+            Barrier barrier(threads, kind);
+            std::vector<BarrierArgs> args(threads);
+            std::vector<pthread_t> ids(threads);
+            long long start = nowNs();
+            for (int i = 0; i < threads; ++i) {
+                args[i] = {&barrier, i};
+                if (pthread_create(&ids[i], nullptr, passBarrier, &args[i]) != 0) {
+                    fprintf(stderr, "bench_mapreduce: couldn't create a barrier thread.\n");
+                    exit(1);
+                }
+            }
+            for (pthread_t id : ids) {
+                pthread_join(id, nullptr);
+            }
+            long long elapsed = nowNs() - start;
+            addResult("barrier",
+                      "\"kind\": \"" + std::string(names[kind]) + "\", " +
+                      field("threads", (long long) threads) + ", " +
+                      field("rounds", (long long) BARRIER_ROUNDS) + ", " +
+                      field("us_per_barrier", elapsed / 1e3 / BARRIER_ROUNDS));
+        }
+    }
+}
+
+/**
+ * The state of a controller that sleeps until its jobs' completion callbacks wake it.
+ */
+struct Controller {
+    pthread_mutex_t mutex;
+    pthread_cond_t cv;
+    int done;
+};
+
+static void onJobDone(JobHandle job, void* arg)
+{
+    (void) job;
+    auto* controller = (Controller*) arg;
+    pthread_mutex_lock(&controller->mutex);
+    ++controller->done;
+    pthread_cond_signal(&controller->cv);
+    pthread_mutex_unlock(&controller->mutex);
+}
+
+/**
+ * A controller running COMPLETION_JOBS jobs, COMPLETION_IN_FLIGHT at a time, and learning when each is done by
+ * polling getJobState, by timed waits, and by completion callbacks. wakeups_per_job counts the controller's
+ * getJobState calls, waits or wake ups per job.
+ */
+static void benchCompletion()
+{
+    TinyMapClient client;
+    InputVec input;
+    makeIntInput(input, COMPLETION_INPUT);
+    const int threads = 2;
+
+    for (const char* mode : {"polling", "timed_wait", "callback"}) {
+        Controller controller = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0};
+        long long wakeups = 0;
+        long long start = nowNs();
+        for (int first = 0; first < COMPLETION_JOBS; first += COMPLETION_IN_FLIGHT) {
+            OutputVec outputs[COMPLETION_IN_FLIGHT];
+            JobHandle jobs[COMPLETION_IN_FLIGHT];
+            controller.done = 0;
+            for (int i = 0; i < COMPLETION_IN_FLIGHT; ++i) {
+                jobs[i] = startMapReduceJob(client, input, outputs[i], threads, JobConfig());
+                if (strcmp(mode, "callback") == 0) {
+                    setJobCompletionCallback(jobs[i], onJobDone, &controller);
+                }
+            }
+            if (strcmp(mode, "callback") == 0) {
+                pthread_mutex_lock(&controller.mutex);
+                while (controller.done < COMPLETION_IN_FLIGHT) {
+                    pthread_cond_wait(&controller.cv, &controller.mutex);
+                    ++wakeups;
+                }
+                pthread_mutex_unlock(&controller.mutex);
+            }
+            for (int i = 0; i < COMPLETION_IN_FLIGHT; ++i) {
+                if (strcmp(mode, "polling") == 0) {
+                    JobState state = {UNDEFINED_STAGE, 0};
+                    while (state.stage != REDUCE_STAGE || state.percentage < 100) {
+                        getJobState(jobs[i], &state);
+                        ++wakeups;
+                    }
+                } else if (strcmp(mode, "timed_wait") == 0) {
+                    while (!waitForJobFor(jobs[i], 1000)) {
+                        ++wakeups;
+                    }
+                    ++wakeups;
+                }
+                closeJobHandle(jobs[i]);
+                checkCounts(outputs[i], COMPLETION_INPUT / SCALING_EMIT_EVERY, "completion");
+                freeOutput(outputs[i]);
+            }
+        }
+        long long elapsed = nowNs() - start;
+        addResult("completion",
+                  "\"mode\": \"" + std::string(mode) + "\", " +
+                  field("jobs", (long long) COMPLETION_JOBS) + ", " +
+                  field("in_flight", (long long) COMPLETION_IN_FLIGHT) + ", " +
+                  field("wakeups_per_job", (double) wakeups / COMPLETION_JOBS) + ", " +
+                  field("us_per_job", elapsed / 1e3 / COMPLETION_JOBS));
+    }
+    freeInput(input);
+}
+
+/**
+ * A word count cancelled at a quarter, half and three quarters of the time it takes to finish. cancel_ms is the time
+ * from cancelJob until closeJobHandle returns, when all of the job's threads and pairs are released.
+ */
+static void benchCancel()
+{
+    WordCountClient client;
+    InputVec input;
+    makeLineInput(input, WORD_COUNT_LINES);
+    const int threads = 4;
+
+    OutputVec output;
+    long long fullNs = timeJob(client, input, output, threads, JobConfig());
+    checkCounts(output, (long long) WORD_COUNT_LINES * WORDS_PER_LINE, "cancel");
+    freeOutput(output);
+
+    for (int quarter = 1; quarter <= 3; ++quarter) {
+        JobHandle job = startMapReduceJob(client, input, output, threads, JobConfig());
+        long long delayNs = fullNs * quarter / 4;
+        timespec delay = {(time_t) (delayNs / NSEC_PER_SEC), (long) (delayNs % NSEC_PER_SEC)};
+        nanosleep(&delay, nullptr);
+        JobState state;
+        getJobState(job, &state);
+        long long start = nowNs();
+        cancelJob(job);
+        closeJobHandle(job);
+        long long cancelNs = nowNs() - start;
+        freeOutput(output);
+        addResult("cancel",
+                  field("threads", (long long) threads) + ", " +
+                  field("input_lines", (long long) WORD_COUNT_LINES) + ", " +
+                  field("job_ms", fullNs / 1e6) + ", " +
+                  field("cancelled_at_stage", (long long) state.stage) + ", " +
+                  field("cancelled_at_percentage", (double) state.percentage) + ", " +
+                  field("cancel_ms", cancelNs / 1e6));
+    }
+    freeInput(input);
+}
+
+/**
+ * The per phase breakdown of a word count, as getJobStats reports it, with the pairs grouped by sorting and by
+ * hashing. The trace of the sorted run is written to a temporary file, to check dumpJobTrace and time it.
+ */
+static void benchStats()
+{
+    static const char* PHASES[NUM_OF_PHASES] = {"map", "sort", "barrier", "shuffle", "reduce", "output"};
+    WordCountClient client;
+    InputVec input;
+    makeLineInput(input, WORD_COUNT_LINES);
+    const int threads = 4;
+    const char* dir = getenv("TMPDIR");
+    std::string path = std::string(dir ? dir : "/tmp") + "/bench_mapreduce-" + std::to_string(getpid()) + ".json";
+
+    for (bool hashed : {false, true}) {
+        JobConfig config;
+        config.hashPartition = hashed;
+        OutputVec output;
+        JobHandle job = startMapReduceJob(client, input, output, threads, config);
+        waitForJob(job);
+        JobStats stats;
+        if (!getJobStats(job, &stats)) {
+            fprintf(stderr, "bench_mapreduce: stats of a done job were not given.\n");
+            exit(1);
+        }
+        long long start = nowNs();
+        if (!hashed && !dumpJobTrace(job, path.c_str())) {
+            fprintf(stderr, "bench_mapreduce: couldn't write %s.\n", path.c_str());
+            exit(1);
+        }
+        long long traceNs = nowNs() - start;
+        closeJobHandle(job);
+        checkCounts(output, (long long) WORD_COUNT_LINES * WORDS_PER_LINE, "stats");
+        if (stats.emitted2 != (unsigned long) WORD_COUNT_LINES * WORDS_PER_LINE ||
+            stats.emitted3 != output.size()) {
+            fprintf(stderr, "bench_mapreduce: stats counted %lu and %lu pairs instead of %d and %zu.\n",
+                    stats.emitted2, stats.emitted3, WORD_COUNT_LINES * WORDS_PER_LINE, output.size());
+            exit(1);
+        }
+
+        std::string phases;
+        double barrierMs = 0;
+        for (int phase = 0; phase < NUM_OF_PHASES; ++phase) {
+            phases += field((std::string(PHASES[phase]) + "_ms").c_str(), stats.phaseMs[phase]) + ", ";
+        }
+        for (const WorkerStats& worker : stats.workers) {
+            barrierMs = std::max(barrierMs, worker.phaseMs[BARRIER_PHASE]);
+        }
+        addResult("stats",
+                  field("threads", (long long) threads) + ", " +
+                  field("hash_partition", (long long) hashed) + ", " +
+                  field("total_ms", stats.totalMs) + ", " + phases +
+                  field("max_worker_barrier_ms", barrierMs) + ", " +
+                  field("emitted2", (long long) stats.emitted2) + ", " +
+                  field("emitted3", (long long) stats.emitted3) + ", " +
+                  field("groups", (long long) stats.groups) + ", " +
+                  field("comparisons", (long long) stats.comparisons) + ", " +
+                  field("trace_ms", traceNs / 1e6));
+        freeOutput(output);
+    }
+    unlink(path.c_str());
+    freeInput(input);
+}
+
+/**
+ * Latency of many small jobs run one after the other, with threads of their own and on the worker pool.
+ */
+static void benchSmallJobs()
+{
+    TinyMapClient client;
+    InputVec input;
+    makeIntInput(input, SMALL_JOB_INPUT);
+
+    for (bool pooled : {false, true}) {
+        if (pooled) {
+            initWorkerPool(SMALL_JOB_THREADS);
+        }
+        long long total = 0;
+        for (int i = 0; i < SMALL_JOBS; ++i) {
+            OutputVec output;
+            total += timeJob(client, input, output, SMALL_JOB_THREADS, JobConfig());
+            checkCounts(output, SMALL_JOB_INPUT / SCALING_EMIT_EVERY, "small_jobs");
+            freeOutput(output);
+        }
+        if (pooled) {
+            shutdownWorkerPool();
+        }
+        addResult("small_jobs",
+                  field("threads", (long long) SMALL_JOB_THREADS) + ", " +
+                  field("pooled", (long long) pooled) + ", " +
+                  field("jobs", (long long) SMALL_JOBS) + ", " +
+                  field("input_pairs", (long long) SMALL_JOB_INPUT) + ", " +
+                  field("us_per_job", total / 1e3 / SMALL_JOBS));
+    }
+    freeInput(input);
+}
+
+/**
+ * Scaling of a word count, whose many distinct keys make the shuffle a large part of the job, with the pairs
+ * grouped by sorting and by hashing.
+ */
+static void benchWordCount()
+{
+    WordCountClient client;
+    InputVec input;
+    makeLineInput(input, WORD_COUNT_LINES);
+
+    for (int threads : THREAD_LEVELS) {
+        for (bool hashed : {false, true}) {
+            JobConfig config;
+            config.hashPartition = hashed;
+            OutputVec output;
+            long long elapsed = timeJob(client, input, output, threads, config);
+            checkCounts(output, (long long) WORD_COUNT_LINES * WORDS_PER_LINE, "word_count");
+            if (output.size() > VOCABULARY_SIZE) {
+                fprintf(stderr, "bench_mapreduce: word_count reduced a word more than once.\n");
+                exit(1);
+            }
+            addResult("word_count",
+                      field("threads", (long long) threads) + ", " +
+                      field("hash_partition", (long long) hashed) + ", " +
+                      field("input_lines", (long long) WORD_COUNT_LINES) + ", " +
+                      field("distinct_words", (long long) output.size()) + ", " +
+                      field("ms", elapsed / 1e6));
+            freeOutput(output);
+        }
+    }
+    freeInput(input);
+}
+
+struct Scenario {
+    const char* name;
+    void (*run)();
+};
+
+static const Scenario SCENARIOS[] = {
+        {"map_scaling", benchMapScaling},
+        {"progress_polling", benchProgressPolling},
+        {"small_jobs", benchSmallJobs},
+        {"combiner", benchCombiner},
+        {"reduce_heavy", benchReduceHeavy},
+        {"word_count", benchWordCount},
+        {"typed_word_count", benchTypedWordCount},
+        {"spill", benchSpill},
+        {"streaming", benchStreaming},
+        {"mapped_text", benchMappedText},
+        {"skewed_map", benchSkewedMap},
+        {"hot_keys", benchHotKeys},
+        {"key_sort", benchKeySort},
+        {"barrier", benchBarrier},
+        {"completion", benchCompletion},
+        {"cancel", benchCancel},
+        {"stats", benchStats},
+};
+
+int main(int argc, char** argv)
+{
+    for (const Scenario& scenario : SCENARIOS) {
+        bool selected = (argc == 1);
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || (strcmp(argv[i], scenario.name) == 0);
+        }
+        if (selected) {
+            scenario.run();
+        }
+    }
+
+    printf("{\n  \"library\": \"MapReduceFramework\",\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        printf("    %s%s\n", results[i].c_str(), (i + 1 < results.size()) ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}